@@ -24,15 +24,21 @@ project 'logger'
 	logger_srcdir = srcdir .. 'logger/'
 
 	includedirs {
-		thirdpartydir
+		thirdpartydir,
+		thirdpartydir .. 'miniz/'
 	}
 
 	files {
 		logger_srcdir .. '**.h',
 		logger_srcdir .. '**.hpp',
 		logger_srcdir .. '**.cpp',
+		thirdpartydir .. 'miniz/miniz.h',
+		thirdpartydir .. 'miniz/miniz.c'
 	}
 
+	-- only the compressor of miniz is used; zlib names of miniz.h would clash with the logger ones
+	defines { 'MINIZ_NO_ZLIB_COMPATIBLE_NAMES', 'MINIZ_NO_ARCHIVE_APIS' }
+
 	filter 'configurations:Debug'
 		defines { '_DEBUG' }
 		symbols 'On'
@@ -94,3 +100,59 @@ project 'logger_test'
 	filter 'configurations:Release'
 		defines { 'NDEBUG' }
 		optimize 'On'
+
+project 'logger_benchmark'
+	kind 'ConsoleApp'
+	language 'C++'
+	cppdialect 'C++20'
+	targetdir (outputdir)
+	objdir (intermadiatedir)
+
+	includedirs {
+		srcdir
+	}
+
+	logger_benchmark_srcdir = srcdir .. 'benchmark/'
+	files {
+		logger_benchmark_srcdir .. '**.hpp',
+		logger_benchmark_srcdir .. '**.cpp'
+	}
+
+	links { 'logger' }
+	libdirs { libdir }
+
+	filter 'configurations:Debug'
+		defines { '_DEBUG' }
+		symbols 'On'
+
+	filter 'configurations:Release'
+		defines { 'NDEBUG' }
+		optimize 'On'
+
+project 'logdecode'
+	kind 'ConsoleApp'
+	language 'C++'
+	cppdialect 'C++20'
+	targetdir (outputdir)
+	objdir (intermadiatedir)
+
+	includedirs {
+		srcdir
+	}
+
+	logdecode_srcdir = srcdir .. 'logdecode/'
+	files {
+		logdecode_srcdir .. '**.hpp',
+		logdecode_srcdir .. '**.cpp'
+	}
+
+	links { 'logger' }
+	libdirs { libdir }
+
+	filter 'configurations:Debug'
+		defines { '_DEBUG' }
+		symbols 'On'
+
+	filter 'configurations:Release'
+		defines { 'NDEBUG' }
+		optimize 'On'
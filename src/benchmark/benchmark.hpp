@@ -0,0 +1,45 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <string_view>
+
+namespace logger_benchmark
+{
+
+/// <summary>
+/// Run function the specified number of times and print average time of one iteration
+/// </summary>
+template<class Func>
+inline double run_benchmark(std::string_view name, size_t iterations, Func&& func)
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	for (size_t i = 0; i < iterations; ++i)
+		func(i);
+
+	const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+	const double ns_per_iteration = elapsed.count() / static_cast<double>(iterations);
+
+	std::printf("%-48.*s %12.1f ns/op %14.0f op/s\n",
+				static_cast<int>(name.size()), name.data(),
+				ns_per_iteration, 1e9 / ns_per_iteration);
+
+	return ns_per_iteration;
+}
+
+/// <summary>
+/// Prevent compiler from optimizing away the value
+/// </summary>
+template<class T>
+inline void do_not_optimize(const T& value)
+{
+	static volatile const void* sink;
+	sink = &value;
+}
+
+void pattern_benchmark();
+void time_benchmark();
+void file_benchmark();
+
+} // namespace logger_benchmark
@@ -0,0 +1,10 @@
+#include "benchmark.hpp"
+
+int main()
+{
+	logger_benchmark::pattern_benchmark();
+	logger_benchmark::time_benchmark();
+	logger_benchmark::file_benchmark();
+
+	return 0;
+}
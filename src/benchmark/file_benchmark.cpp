@@ -0,0 +1,72 @@
+#include "benchmark.hpp"
+
+#include "logger/logger.hpp"
+#include "logger/binary_file_policy.hpp"
+#include "logger/default_file_policy.hpp"
+#include "logger/direct_file_policy.hpp"
+#include "logger/mmap_file_policy.hpp"
+#include "logger/uring_file_policy.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+namespace logger_benchmark
+{
+
+namespace
+{
+
+constexpr size_t ITERATIONS = 200'000;
+constexpr std::string_view LOG_FILE = "benchmark_log.log";
+
+template<class Policy>
+void run_file_benchmark(std::string_view name, const logger::LoggerConfig& config)
+{
+	{
+		const logger::Logger<Policy> log(config);
+		Policy::set_file_path(LOG_FILE);
+
+		run_benchmark(name, ITERATIONS, [&log](size_t i)
+		{
+			log.info("request {} done in {} ms", i, 42);
+		});
+	}
+
+	std::filesystem::remove(LOG_FILE);
+
+	for (size_t i = 0; std::filesystem::remove(logger::MmapFileLoggerPolicy::segment_path(LOG_FILE, i)); ++i)
+		;
+}
+
+} // namespace
+
+void file_benchmark()
+{
+	std::printf("file logging (op/s is lines per second):\n");
+
+	logger::LoggerConfig config;
+	config.log_pattern = "[{{time}}][{{thread-id}}][{{level}}] {{message}}";
+
+	config.file_buffer_size = 0;
+	run_file_benchmark<logger::DefaultFileLoggerPolicy>("flush every line (previous)", config);
+
+	config.file_buffer_size = logger::DEFAULT_FILE_BUFFER_SIZE;
+	run_file_benchmark<logger::DefaultFileLoggerPolicy>("buffered, default flush strategy", config);
+
+	config.file_buffer_size = 1024 * 1024;
+	config.flush_interval = std::chrono::milliseconds(0);
+	run_file_benchmark<logger::DefaultFileLoggerPolicy>("buffered 1 MB, no flush interval", config);
+
+	run_file_benchmark<logger::MmapFileLoggerPolicy>("MmapFileLoggerPolicy", config);
+
+	run_file_benchmark<logger::DirectFileLoggerPolicy>("DirectFileLoggerPolicy", config);
+
+	run_file_benchmark<logger::BinaryFileLoggerPolicy>("BinaryFileLoggerPolicy", config);
+
+#if defined(__linux__)
+	run_file_benchmark<logger::UringFileLoggerPolicy>("UringFileLoggerPolicy", config);
+#endif
+}
+
+} // namespace logger_benchmark
@@ -0,0 +1,56 @@
+#include "benchmark.hpp"
+
+#include "logger/log_pattern.hpp"
+#include "logger/logger_config.hpp"
+
+#include <format>
+#include <string>
+
+namespace logger_benchmark
+{
+
+namespace
+{
+
+constexpr size_t ITERATIONS = 2'000'000;
+
+} // namespace
+
+void pattern_benchmark()
+{
+	std::printf("log pattern formatting: \"%s\"\n", logger::DEFAULT_LOG_PATTERN.data());
+
+	const std::string_view time = "2025-01-01 12:00:00.000 UTC+3";
+	const std::string_view thread_id = "140245363214016";
+	const std::string_view level = "info";
+	const std::string_view message = "request processed, status 200, 1532 bytes sent";
+
+	std::string format (logger::DEFAULT_LOG_PATTERN);
+	logger::replace_log_pattern_placeholders(format);
+
+	run_benchmark("std::vformat (previous implementation)", ITERATIONS, [&](size_t)
+	{
+		const std::string log_entry = std::vformat(format, std::make_format_args(time, thread_id, level, message));
+		do_not_optimize(log_entry);
+	});
+
+	const logger::CompiledLogPattern compiled (logger::DEFAULT_LOG_PATTERN);
+
+	run_benchmark("CompiledLogPattern", ITERATIONS, [&](size_t)
+	{
+		std::string log_entry;
+		compiled.format_to(log_entry, { time, thread_id, level, message });
+		do_not_optimize(log_entry);
+	});
+
+	using static_pattern_t = logger::StaticLogPattern<"[{{time}}][[thread-id={{thread-id}}]][{{log-level}}] {{message}}">;
+
+	run_benchmark("StaticLogPattern", ITERATIONS, [&](size_t)
+	{
+		std::string log_entry;
+		static_pattern_t::format_to(log_entry, { time, thread_id, level, message });
+		do_not_optimize(log_entry);
+	});
+}
+
+} // namespace logger_benchmark
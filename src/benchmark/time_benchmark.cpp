@@ -0,0 +1,44 @@
+#include "benchmark.hpp"
+
+#include "logger/providers/time_provider.hpp"
+
+#include <chrono>
+#include <format>
+#include <string>
+
+namespace logger_benchmark
+{
+
+namespace
+{
+
+constexpr size_t ITERATIONS = 1'000'000;
+
+} // namespace
+
+void time_benchmark()
+{
+	using namespace std::chrono;
+
+	std::printf("time formatting:\n");
+
+	run_benchmark("std::format with tzdb lookup (previous)", ITERATIONS, [](size_t)
+	{
+		const auto now = system_clock::now();
+		const auto now_ms = duration_cast<milliseconds>(now.time_since_epoch()) % 1000;
+		const auto tz_offset = duration_cast<minutes>(current_zone()->get_info(now).offset).count();
+
+		const std::string time = std::format("{:%Y-%m-%d %H:%M:%S}.{:03d} UTC{:+}", floor<seconds>(now), now_ms.count(), tz_offset / 60);
+		do_not_optimize(time);
+	});
+
+	const logger::DefaultTimeProvider provider;
+
+	run_benchmark("DefaultTimeProvider::now", ITERATIONS, [&provider](size_t)
+	{
+		const std::string time = provider.now();
+		do_not_optimize(time);
+	});
+}
+
+} // namespace logger_benchmark
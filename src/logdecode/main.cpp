@@ -0,0 +1,221 @@
+#include "logger/binary_log_decoder.hpp"
+#include "logger/log_level.hpp"
+#include "logger/logger_config.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <exception>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+constexpr std::string_view USAGE =
+	"Usage: logdecode [options] <file>...\n"
+	"Render binary logs of BinaryFileLoggerPolicy as text.\n"
+	"\n"
+	"Options:\n"
+	"  --pattern <pattern>  log pattern ({{time}}, {{thread-id}}, {{level}}, {{message}})\n"
+	"  --config <file>      take log_pattern from the logger configuration file\n"
+	"  --level <level>      minimal level: debug, info, warning or error\n"
+	"  --from <time>        skip records before the time: \"YYYY-MM-DD HH:MM[:SS[.mmm]]\" of local time,\n"
+	"                       UTC with \"Z\" suffix\n"
+	"  --to <time>          skip records from the time\n"
+	"  --threads <count>    decoding threads, count of hardware threads by default\n"
+	"  --output <file>      write to the file instead of the standard output\n"
+	"  --stats              print counts of blocks and records to the standard error\n"
+	"  --help               print this help\n";
+
+struct Arguments
+{
+	logger::BinaryLogDecodeOptions options;
+	std::vector<std::string> files;
+	std::string output;
+	bool stats = false;
+	bool help = false;
+};
+
+unsigned parse_number(std::string_view str, std::string_view what)
+{
+	unsigned value = 0;
+	const auto [end, error] = std::from_chars(str.data(), str.data() + str.size(), value);
+	if (error != std::errc() || end != str.data() + str.size())
+		throw std::invalid_argument(std::format("invalid {} \"{}\"", what, str));
+
+	return value;
+}
+
+logger::Level parse_level(std::string_view str)
+{
+	for (const logger::Level level : { logger::Level::DEBUG, logger::Level::INFO, logger::Level::WARNING, logger::Level::ERROR })
+	{
+		if (logger::level_to_str(level) == str)
+			return level;
+	}
+
+	throw std::invalid_argument(std::format("unknown level \"{}\"", str));
+}
+
+logger::TimeProvider::time_point parse_time(std::string_view str)
+{
+	using namespace std::chrono;
+
+	const std::string_view original = str;
+	const bool utc = !str.empty() && str.back() == 'Z';
+	if (utc)
+		str.remove_suffix(1);
+
+	// "YYYY-MM-DD HH:MM[:SS[.mmm]]", 'T' is accepted instead of the space
+	auto field = [&str, original](size_t size, std::string_view separators) -> unsigned
+	{
+		if (str.size() < size)
+			throw std::invalid_argument(std::format("invalid time \"{}\"", original));
+
+		const unsigned value = parse_number(str.substr(0, size), "time");
+		str.remove_prefix(size);
+
+		if (!separators.empty())
+		{
+			if (str.empty() || separators.find(str.front()) == std::string_view::npos)
+				throw std::invalid_argument(std::format("invalid time \"{}\"", original));
+
+			str.remove_prefix(1);
+		}
+
+		return value;
+	};
+
+	const unsigned y = field(4, "-");
+	const unsigned m = field(2, "-");
+	const unsigned d = field(2, " T");
+	const unsigned h = field(2, ":");
+	const unsigned min = field(2, str.size() > 2 ? ":" : "");
+
+	unsigned s = 0;
+	unsigned ms = 0;
+	if (!str.empty())
+	{
+		s = field(2, str.size() > 2 ? "." : "");
+		if (!str.empty())
+			ms = field(3, "");
+	}
+
+	const year_month_day date { year(static_cast<int>(y)), month(m), day(d) };
+	if (!date.ok() || h > 23 || min > 59 || s > 59 || !str.empty())
+		throw std::invalid_argument(std::format("invalid time \"{}\"", original));
+
+	const auto time_of_day = hours(h) + minutes(min) + seconds(s) + milliseconds(ms);
+
+	if (utc)
+		return time_point_cast<system_clock::duration>(sys_days(date) + time_of_day);
+
+	return time_point_cast<system_clock::duration>(current_zone()->to_sys(local_days(date) + time_of_day));
+}
+
+Arguments parse_arguments(int argc, char* argv[])
+{
+	Arguments arguments;
+	arguments.options.threads = std::max(1u, std::thread::hardware_concurrency());
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string_view arg = argv[i];
+
+		auto value = [&]() -> std::string_view
+		{
+			if (i + 1 >= argc)
+				throw std::invalid_argument(std::format("{} requires a value", arg));
+
+			return argv[++i];
+		};
+
+		if (arg == "--help" || arg == "-h")
+			arguments.help = true;
+		else if (arg == "--pattern")
+			arguments.options.log_pattern = value();
+		else if (arg == "--config")
+			arguments.options.log_pattern = logger::read_config(std::string(value())).log_pattern;
+		else if (arg == "--level")
+			arguments.options.min_level = parse_level(value());
+		else if (arg == "--from")
+			arguments.options.from = parse_time(value());
+		else if (arg == "--to")
+			arguments.options.to = parse_time(value());
+		else if (arg == "--threads")
+			arguments.options.threads = std::max(1u, parse_number(value(), "count of threads"));
+		else if (arg == "--output")
+			arguments.output = value();
+		else if (arg == "--stats")
+			arguments.stats = true;
+		else if (arg.starts_with("--"))
+			throw std::invalid_argument(std::format("unknown option {}", arg));
+		else
+			arguments.files.emplace_back(arg);
+	}
+
+	if (arguments.files.empty() && !arguments.help)
+		throw std::invalid_argument("no files to decode");
+
+	return arguments;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	try
+	{
+		const Arguments arguments = parse_arguments(argc, argv);
+
+		if (arguments.help)
+		{
+			std::cout << USAGE;
+			return 0;
+		}
+
+		std::ofstream output_file;
+		if (!arguments.output.empty())
+		{
+			output_file.open(arguments.output, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!output_file)
+				throw std::runtime_error(std::format("can't create file \"{}\"", arguments.output));
+		}
+
+		std::ostream& out = arguments.output.empty() ? std::cout : output_file;
+
+		for (const std::string& file : arguments.files)
+		{
+			const logger::BinaryLogDecodeStats stats = logger::decode_binary_log(file, arguments.options, out);
+
+			if (arguments.stats)
+			{
+				std::cerr << std::format("{}: {} blocks ({} skipped), {} records, {} written, {} errors",
+										 file, stats.blocks, stats.skipped_blocks, stats.records, stats.written, stats.errors)
+						  << std::endl;
+			}
+		}
+
+		out.flush();
+	}
+	catch (const std::invalid_argument& e)
+	{
+		std::cerr << "Error: " << e.what() << "\n\n" << USAGE;
+		return 2;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
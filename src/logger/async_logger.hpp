@@ -0,0 +1,491 @@
+#pragma once
+
+#include "logger.hpp"
+#include "mpsc_queue.hpp"
+#include "packed_args.hpp"
+#include "log_record.hpp"
+
+#include <array>
+#include <atomic>
+#include <format>
+#include <memory>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace logger
+{
+
+/// <summary>
+/// Maximal count of log entries the writer thread passes to policies at once (see batch_policy)
+/// </summary>
+constexpr size_t ASYNC_BATCH_SIZE = 64;
+
+/// <summary>
+/// Raw log record captured on the calling thread: nothing is formatted yet.
+/// </summary>
+struct AsyncRecord
+{
+	TimeProvider::time_point time;
+	std::string_view thread_id;  // interned by this_thread_id
+	Level level = Level::DEBUG;
+	std::string_view format;
+	format_packed_args_t* format_args = nullptr;
+	ArgsBuffer args;
+	std::source_location location;
+};
+
+/// <summary>
+/// Records the writer thread took from the queue at once with their formatted messages and log entries
+/// </summary>
+struct AsyncBatch
+{
+	std::array<AsyncRecord, ASYNC_BATCH_SIZE> raw_records;
+	size_t size = 0;
+
+	// messages and entries are stored one after another, records and views refer to them
+	std::string messages;
+	std::string entries;
+	std::array<LogRecord, ASYNC_BATCH_SIZE> records;
+	std::array<std::string_view, ASYNC_BATCH_SIZE> entries_views;
+};
+
+/// <summary>
+/// Count of batches the writer thread could format ahead of the slowest policy in ParallelFanOut mode
+/// </summary>
+constexpr size_t FAN_OUT_RING_SIZE = 16;
+
+/// <summary>
+/// AsyncLogger option: every policy gets its own thread (lane) that reads formatted batches from the shared ring,
+/// so policies write in parallel and a slow policy doesn't delay others while it lags behind
+/// by less than FAN_OUT_RING_SIZE batches. Records are formatted once by the writer thread.
+/// AsyncLogger<ParallelFanOut, DefaultFileLoggerPolicy, DefaultConsoleLoggerPolicy>
+/// </summary>
+struct ParallelFanOut
+{
+	using logger_option_tag = void;
+};
+
+/// <summary>
+/// Logger that hands log records to a dedicated writer thread through a bounded lock-free queue.
+/// The calling thread only captures time, thread id, pointer to the format string and a binary copy
+/// of arguments; message and log entry formatting and policies calls happen on the writer thread.
+/// If the queue is full, callers wait until the writer thread frees a cell: no record is dropped.
+/// The writer thread drains the queue in batches of up to ASYNC_BATCH_SIZE entries (see batch_policy).
+/// </summary>
+template<logger_component... Policies>
+class AsyncLogger : public LoggerBase<Policies...>
+{
+	using base_t = LoggerBase<Policies...>;
+
+public:
+	using Level = Level;
+
+	static constexpr bool fan_out = (std::is_same_v<Policies, ParallelFanOut> || ...);
+
+	explicit AsyncLogger(LoggerConfig config = LoggerConfig());
+	~AsyncLogger();
+
+	void log(Level level, const std::string_view message, std::source_location location = std::source_location::current()) const;
+
+	/// <summary>
+	/// Log message with deferred formatting. Format string must be a string literal (or any other string
+	/// with static storage duration), because only the pointer to it is passed to the writer thread.
+	/// Arguments that don't satisfy packable_arg concept are formatted on the calling thread.
+	/// </summary>
+	template<class... Args>
+	void log(Level level, located_format_string<Args...> format, Args&&... args) const;
+
+	inline void debug(const std::string_view message, std::source_location location = std::source_location::current())   const { if constexpr (base_t::is_enabled(Level::DEBUG)) log(Level::DEBUG, message, location); }
+	inline void info(const std::string_view message, std::source_location location = std::source_location::current())    const { if constexpr (base_t::is_enabled(Level::INFO)) log(Level::INFO, message, location); }
+	inline void warning(const std::string_view message, std::source_location location = std::source_location::current()) const { if constexpr (base_t::is_enabled(Level::WARNING)) log(Level::WARNING, message, location); }
+	inline void error(const std::string_view message, std::source_location location = std::source_location::current())   const { if constexpr (base_t::is_enabled(Level::ERROR)) log(Level::ERROR, message, location); }
+
+	template<class... Args>
+	inline void debug(located_format_string<Args...> format, Args&&... args) const { if constexpr (base_t::is_enabled(Level::DEBUG)) log(Level::DEBUG, format, std::forward<Args>(args)...); }
+	template<class... Args>
+	inline void info(located_format_string<Args...> format, Args&&... args) const { if constexpr (base_t::is_enabled(Level::INFO)) log(Level::INFO, format, std::forward<Args>(args)...); }
+	template<class... Args>
+	inline void warning(located_format_string<Args...> format, Args&&... args) const { if constexpr (base_t::is_enabled(Level::WARNING)) log(Level::WARNING, format, std::forward<Args>(args)...); }
+	template<class... Args>
+	inline void error(located_format_string<Args...> format, Args&&... args) const { if constexpr (base_t::is_enabled(Level::ERROR)) log(Level::ERROR, format, std::forward<Args>(args)...); }
+
+	/// <summary>
+	/// Block until all entries logged before the call are written by policies.
+	/// </summary>
+	void flush() const;
+
+private:
+	template<class... Args>
+	void push(Level level, const std::source_location& location, std::string_view format, const Args&... args) const;
+
+	void wake_writer() const;
+	void writer_loop();
+	size_t drain();
+	void format_batch(AsyncBatch& batch) const;
+	static void release_args(AsyncBatch& batch);
+
+	template<class Policy>
+	void write_batch(const AsyncBatch& batch) const;
+
+	// parallel fan-out
+	template<size_t... I>
+	void start_lanes(std::index_sequence<I...>);
+	template<class Policy, size_t I>
+	void start_lane();
+	template<class Policy, size_t I>
+	void lane_loop();
+	AsyncBatch& next_fan_out_batch();
+	void publish_fan_out_batch();
+	void wait_lanes(size_t consumed) const;
+	void stop_lanes();
+
+	struct Lane
+	{
+		alignas(CACHE_LINE_SIZE) std::atomic<size_t> consumed = 0;
+		std::thread thread;
+	};
+
+	static constexpr std::array<bool, sizeof...(Policies)> active_lanes_ = { (fan_out && output_policy<Policies>)... };
+
+	mutable MpscQueue<AsyncRecord> queue_;
+
+	alignas(CACHE_LINE_SIZE) mutable std::atomic<bool> writer_sleeping_ = false;
+	alignas(CACHE_LINE_SIZE) std::atomic<size_t> written_ = 0;
+	std::atomic<bool> stop_ = false;
+
+	// the only batch or the ring of FAN_OUT_RING_SIZE batches in fan-out mode
+	const std::unique_ptr<AsyncBatch[]> batches_;
+
+	alignas(CACHE_LINE_SIZE) std::atomic<size_t> published_ = 0;
+	std::atomic<size_t> lanes_epoch_ = 0;
+	std::atomic<bool> lanes_stop_ = false;
+	std::array<Lane, sizeof...(Policies)> lanes_;
+
+	std::thread writer_;
+
+}; // class AsyncLogger
+
+template<logger_component ...Policies>
+inline AsyncLogger<Policies...>::AsyncLogger(LoggerConfig config)
+	: base_t(std::move(config))
+	, queue_(base_t::get_config().async_queue_size)
+	, batches_(std::make_unique<AsyncBatch[]>(fan_out ? FAN_OUT_RING_SIZE : 1))
+{
+	if constexpr (fan_out)
+		start_lanes(std::index_sequence_for<Policies...>());
+
+	writer_ = std::thread(&AsyncLogger::writer_loop, this);
+}
+
+template<logger_component ...Policies>
+inline AsyncLogger<Policies...>::~AsyncLogger()
+{
+	stop_.store(true);
+	writer_sleeping_.store(false);
+	writer_sleeping_.notify_one();
+
+	writer_.join();
+
+	if constexpr (fan_out)
+		stop_lanes();
+}
+
+template<logger_component ...Policies>
+inline void AsyncLogger<Policies...>::log(Level level, const std::string_view message, std::source_location location) const
+{
+	if (this->is_filtered(level))
+		return;
+
+	push(level, location, "{}", message);
+}
+
+template<logger_component ...Policies>
+template<class ...Args>
+inline void AsyncLogger<Policies...>::log(Level level, located_format_string<Args...> format, Args&&... args) const
+{
+	if (this->is_filtered(level))
+		return;
+
+	if constexpr ((packable_arg<Args> && ...))
+		push(level, format.location, format.format.get(), args...);
+	else
+		push(level, format.location, "{}", std::format(format.format, std::forward<Args>(args)...));
+}
+
+template<logger_component ...Policies>
+inline void AsyncLogger<Policies...>::flush() const
+{
+	const size_t target = queue_.enqueued();
+
+	wake_writer();
+
+	while (written_.load(std::memory_order_acquire) < target)
+		std::this_thread::yield();
+
+	// in fan-out mode entries are written when all lanes consume batches published by now
+	if constexpr (fan_out)
+		wait_lanes(published_.load(std::memory_order_acquire));
+}
+
+template<logger_component ...Policies>
+template<class ...Args>
+inline void AsyncLogger<Policies...>::push(Level level, const std::source_location& location, std::string_view format, const Args&... args) const
+{
+	AsyncRecord record;
+	record.time = DependencyContainer::get_cached<TimeProvider>()->timestamp();
+	record.thread_id = this_thread_id(base_t::get_config().thread_id_type);
+	record.level = level;
+	record.format = format;
+	record.format_args = &format_packed_args<Args...>;
+	pack_args(record.args, args...);
+	record.location = location;
+
+	while (!queue_.try_push(std::move(record)))
+	{
+		wake_writer();
+		std::this_thread::yield();
+	}
+
+	wake_writer();
+}
+
+template<logger_component ...Policies>
+inline void AsyncLogger<Policies...>::wake_writer() const
+{
+	// pairs with the fence in writer_loop: either the writer sees the new entry
+	// or we see that it is going to sleep
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	if (writer_sleeping_.load(std::memory_order_relaxed))
+	{
+		writer_sleeping_.store(false, std::memory_order_relaxed);
+		writer_sleeping_.notify_one();
+	}
+}
+
+template<logger_component ...Policies>
+inline void AsyncLogger<Policies...>::writer_loop()
+{
+	for (;;)
+	{
+		if (drain() != 0)
+			continue;
+
+		if (stop_.load())
+			break;
+
+		writer_sleeping_.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		if (queue_.empty() && !stop_.load())
+			writer_sleeping_.wait(true);
+
+		writer_sleeping_.store(false, std::memory_order_relaxed);
+	}
+
+	drain();
+}
+
+template<logger_component ...Policies>
+inline size_t AsyncLogger<Policies...>::drain()
+{
+	size_t count = 0;
+
+	for (;;)
+	{
+		AsyncBatch& batch = fan_out ? next_fan_out_batch() : batches_[0];
+
+		batch.size = 0;
+		while (batch.size < ASYNC_BATCH_SIZE && queue_.try_pop(batch.raw_records[batch.size]))
+			++batch.size;
+
+		if (batch.size == 0)
+			break;
+
+		format_batch(batch);
+
+		if constexpr (fan_out)
+		{
+			publish_fan_out_batch();
+		}
+		else
+		{
+			(write_batch<Policies>(batch), ...);
+			release_args(batch);
+		}
+
+		written_.fetch_add(batch.size, std::memory_order_release);
+		count += batch.size;
+	}
+
+	return count;
+}
+
+template<logger_component ...Policies>
+inline void AsyncLogger<Policies...>::format_batch(AsyncBatch& batch) const
+{
+	const TimeProvider& time_provider = *DependencyContainer::get_cached<TimeProvider>();
+
+	// views are made after formatting of the whole batch, because buffers could be reallocated
+	std::array<size_t, ASYNC_BATCH_SIZE + 1> offsets;
+
+	batch.messages.clear();
+	offsets[0] = 0;
+
+	// packed record policies read the format string and arguments only
+	for (size_t i = 0; i < batch.size; ++i)
+	{
+		const AsyncRecord& record = batch.raw_records[i];
+
+		if constexpr (base_t::formats_messages)
+			record.format_args(batch.messages, record.format, record.args.data());
+
+		offsets[i + 1] = batch.messages.size();
+	}
+
+	for (size_t i = 0; i < batch.size; ++i)
+	{
+		const AsyncRecord& record = batch.raw_records[i];
+		const std::string_view message = std::string_view(batch.messages).substr(offsets[i], offsets[i + 1] - offsets[i]);
+
+		batch.records[i] = LogRecord { record.time, record.thread_id, record.level, message, record.location,
+									   record.format, { record.args.data(), record.args.size() } };
+	}
+
+	if constexpr (base_t::formats_text)
+	{
+		batch.entries.clear();
+
+		for (size_t i = 0; i < batch.size; ++i)
+		{
+			this->format_entry(batch.entries, batch.records[i], time_provider);
+			offsets[i + 1] = batch.entries.size();
+		}
+
+		for (size_t i = 0; i < batch.size; ++i)
+			batch.entries_views[i] = std::string_view(batch.entries).substr(offsets[i], offsets[i + 1] - offsets[i]);
+	}
+}
+
+template<logger_component ...Policies>
+inline void AsyncLogger<Policies...>::release_args(AsyncBatch& batch)
+{
+	// arena blocks go back to producers as soon as the batch is written, not when its cells are reused
+	for (size_t i = 0; i < batch.size; ++i)
+		batch.raw_records[i].args.clear();
+}
+
+template<logger_component ...Policies>
+template<class Policy>
+inline void AsyncLogger<Policies...>::write_batch(const AsyncBatch& batch) const
+{
+	if (batch.size == 1)
+		this->template write_to_policy<Policy>(batch.records[0], batch.entries_views[0]);
+	else
+		this->template write_batch_to_policy<Policy>({ batch.records.data(), batch.size }, { batch.entries_views.data(), batch.size });
+}
+
+template<logger_component ...Policies>
+template<size_t ...I>
+inline void AsyncLogger<Policies...>::start_lanes(std::index_sequence<I...>)
+{
+	(start_lane<Policies, I>(), ...);
+}
+
+template<logger_component ...Policies>
+template<class Policy, size_t I>
+inline void AsyncLogger<Policies...>::start_lane()
+{
+	if constexpr (output_policy<Policy>)
+		lanes_[I].thread = std::thread(&AsyncLogger::lane_loop<Policy, I>, this);
+}
+
+template<logger_component ...Policies>
+template<class Policy, size_t I>
+inline void AsyncLogger<Policies...>::lane_loop()
+{
+	Lane& lane = lanes_[I];
+	size_t next = 0;
+
+	for (;;)
+	{
+		// the epoch is read before the published count, so publishing between the checks and the wait is not lost
+		const size_t epoch = lanes_epoch_.load(std::memory_order_acquire);
+
+		if (next < published_.load(std::memory_order_acquire))
+		{
+			write_batch<Policy>(batches_[next % FAN_OUT_RING_SIZE]);
+
+			lane.consumed.store(++next, std::memory_order_release);
+			lane.consumed.notify_all();
+			continue;
+		}
+
+		if (lanes_stop_.load())
+			break;
+
+		lanes_epoch_.wait(epoch);
+	}
+}
+
+template<logger_component ...Policies>
+inline AsyncBatch& AsyncLogger<Policies...>::next_fan_out_batch()
+{
+	const size_t sequence = published_.load(std::memory_order_relaxed);
+
+	// the ring cell is free when all lanes consumed the batch published FAN_OUT_RING_SIZE batches ago
+	if (sequence >= FAN_OUT_RING_SIZE)
+		wait_lanes(sequence - FAN_OUT_RING_SIZE + 1);
+
+	AsyncBatch& batch = batches_[sequence % FAN_OUT_RING_SIZE];
+	release_args(batch);
+
+	return batch;
+}
+
+template<logger_component ...Policies>
+inline void AsyncLogger<Policies...>::publish_fan_out_batch()
+{
+	published_.fetch_add(1, std::memory_order_release);
+
+	lanes_epoch_.fetch_add(1, std::memory_order_release);
+	lanes_epoch_.notify_all();
+}
+
+template<logger_component ...Policies>
+inline void AsyncLogger<Policies...>::wait_lanes(size_t consumed) const
+{
+	for (size_t i = 0; i < lanes_.size(); ++i)
+	{
+		if (!active_lanes_[i])
+			continue;
+
+		size_t current;
+		while ((current = lanes_[i].consumed.load(std::memory_order_acquire)) < consumed)
+			lanes_[i].consumed.wait(current);
+	}
+}
+
+template<logger_component ...Policies>
+inline void AsyncLogger<Policies...>::stop_lanes()
+{
+	lanes_stop_.store(true);
+
+	lanes_epoch_.fetch_add(1, std::memory_order_release);
+	lanes_epoch_.notify_all();
+
+	for (Lane& lane : lanes_)
+	{
+		if (lane.thread.joinable())
+			lane.thread.join();
+	}
+}
+
+template<class P, class... Policies>
+constexpr bool has_policy_v<AsyncLogger<Policies...>, P> = (std::is_same_v<Policies, P> || ...);
+
+} // namespace logger
@@ -0,0 +1,218 @@
+#include "binary_file_policy.hpp"
+#include "packed_args.hpp"
+
+#include <format>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+// messages logged without format arguments are written as the single string argument
+constexpr std::string_view MESSAGE_FORMAT = "{}";
+
+int64_t to_nanoseconds(logger::TimeProvider::time_point time)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+} // namespace
+
+namespace logger
+{
+
+std::mutex BinaryFileLoggerPolicy::mutex_;
+std::ofstream BinaryFileLoggerPolicy::file_;
+
+std::string BinaryFileLoggerPolicy::block_;
+BinaryBlockHeader BinaryFileLoggerPolicy::header_;
+int64_t BinaryFileLoggerPolicy::last_time_ = 0;
+bool BinaryFileLoggerPolicy::new_session_ = true;
+
+std::unordered_map<const char*, uint32_t> BinaryFileLoggerPolicy::format_addresses_;
+BinaryFileLoggerPolicy::dictionary_t BinaryFileLoggerPolicy::formats_;
+BinaryFileLoggerPolicy::dictionary_t BinaryFileLoggerPolicy::threads_;
+std::string BinaryFileLoggerPolicy::last_thread_id_;
+uint32_t BinaryFileLoggerPolicy::last_thread_index_ = 0;
+
+size_t BinaryFileLoggerPolicy::buffer_size_ = DEFAULT_FILE_BUFFER_SIZE;
+std::chrono::milliseconds BinaryFileLoggerPolicy::flush_interval_ = DEFAULT_FLUSH_INTERVAL;
+std::chrono::steady_clock::time_point BinaryFileLoggerPolicy::last_flush_;
+
+void BinaryFileLoggerPolicy::set_file_path(const fs::path& file_path)
+{
+	release();
+
+	std::scoped_lock lock(mutex_);
+
+	file_.open(file_path, std::ios::out | std::ios::app | std::ios::binary);
+	if (!file_.is_open())
+		throw std::runtime_error(std::format("can't open file \"{}\"", file_path.string()));
+
+	new_session_ = true;
+	format_addresses_.clear();
+	formats_.clear();
+	threads_.clear();
+	last_thread_id_.clear();
+
+	last_flush_ = std::chrono::steady_clock::now();
+}
+
+void BinaryFileLoggerPolicy::configure(const LoggerConfig& config)
+{
+	std::scoped_lock lock(mutex_);
+
+	flush_unlocked();
+
+	buffer_size_ = config.file_buffer_size;
+	flush_interval_ = config.flush_interval;
+	block_.reserve(buffer_size_);
+}
+
+void BinaryFileLoggerPolicy::release()
+{
+	std::scoped_lock lock(mutex_);
+
+	flush_unlocked();
+
+	if (file_.is_open())
+		file_.close();
+}
+
+void BinaryFileLoggerPolicy::write(const LogRecord& record)
+{
+	std::scoped_lock lock(mutex_);
+
+	if (!file_.is_open())
+		return;
+
+	append_unlocked(record);
+	flush_if_needed_unlocked();
+}
+
+void BinaryFileLoggerPolicy::flush()
+{
+	std::scoped_lock lock(mutex_);
+
+	flush_unlocked();
+}
+
+void BinaryFileLoggerPolicy::append_unlocked(const LogRecord& record)
+{
+	const bool packed = !record.format.empty();
+
+	// dictionary entries go before the record
+	const uint32_t format_id = format_id_unlocked(packed ? record.format : MESSAGE_FORMAT);
+	const uint32_t thread_index = thread_index_unlocked(record.thread_id);
+
+	const int64_t time = to_nanoseconds(record.time);
+	if (header_.records_count == 0)
+	{
+		header_.first_time = time;
+		last_time_ = time;
+	}
+
+	block_.push_back(static_cast<char>(BinaryEntryType::RECORD));
+	block_.push_back(static_cast<char>(record.level));
+	append_varint(block_, zigzag_encode(time - last_time_));
+	append_varint(block_, thread_index);
+	append_varint(block_, format_id);
+
+	if (packed)
+	{
+		append_varint(block_, record.args.size());
+		block_.append(reinterpret_cast<const char*>(record.args.data()), record.args.size());
+	}
+	else
+	{
+		const size_t size = internal::packed_size(record.message);
+		append_varint(block_, size);
+
+		const size_t offset = block_.size();
+		block_.resize(offset + size);
+		internal::pack_arg(reinterpret_cast<std::byte*>(block_.data() + offset), record.message);
+	}
+
+	last_time_ = time;
+	header_.last_time = time;
+	++header_.records_count;
+}
+
+uint32_t BinaryFileLoggerPolicy::format_id_unlocked(const std::string_view format)
+{
+	const auto it = format_addresses_.find(format.data());
+	if (it != format_addresses_.end())
+		return it->second;
+
+	// the same text at other address (e.g. the same literal in other translation unit) gets the same id
+	const uint32_t id = find_or_add_unlocked(formats_, BinaryEntryType::FORMAT, format);
+	format_addresses_.emplace(format.data(), id);
+
+	return id;
+}
+
+uint32_t BinaryFileLoggerPolicy::thread_index_unlocked(const std::string_view thread_id)
+{
+	// entries of the same thread usually go in a row
+	if (!last_thread_id_.empty() && thread_id == last_thread_id_)
+		return last_thread_index_;
+
+	last_thread_index_ = find_or_add_unlocked(threads_, BinaryEntryType::THREAD, thread_id);
+	last_thread_id_ = thread_id;
+
+	return last_thread_index_;
+}
+
+uint32_t BinaryFileLoggerPolicy::find_or_add_unlocked(dictionary_t& dictionary, BinaryEntryType type, const std::string_view value)
+{
+	const auto it = dictionary.find(value);
+	if (it != dictionary.end())
+		return it->second;
+
+	const auto id = static_cast<uint32_t>(dictionary.size());
+	dictionary.emplace(std::string(value), id);
+
+	block_.push_back(static_cast<char>(type));
+	append_varint(block_, id);
+	append_varint(block_, value.size());
+	block_.append(value);
+
+	return id;
+}
+
+void BinaryFileLoggerPolicy::flush_unlocked()
+{
+	if (!block_.empty() && file_.is_open())
+	{
+		header_.flags = new_session_ ? BINARY_BLOCK_NEW_SESSION : 0;
+		header_.payload_size = static_cast<uint32_t>(block_.size());
+
+		char header[BinaryBlockHeader::SIZE];
+		write_block_header(header, header_);
+
+		file_.write(header, sizeof(header));
+		file_.write(block_.data(), static_cast<std::streamsize>(block_.size()));
+		file_.flush();
+
+		new_session_ = false;
+	}
+
+	block_.clear();
+	header_ = BinaryBlockHeader();
+	last_flush_ = std::chrono::steady_clock::now();
+}
+
+void BinaryFileLoggerPolicy::flush_if_needed_unlocked()
+{
+	if (block_.size() >= buffer_size_)
+	{
+		flush_unlocked();
+		return;
+	}
+
+	if (flush_interval_.count() > 0 && std::chrono::steady_clock::now() - last_flush_ >= flush_interval_)
+		flush_unlocked();
+}
+
+} // namespace logger
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "logger_concepts.hpp"
+#include "logger_config.hpp"
+#include "binary_log_format.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace logger
+{
+
+/// <summary>
+/// File policy that writes records in the compact binary form (see binary_log_format.hpp):
+/// time delta, thread index, level, format string id and arguments packed by the logger.
+/// Every distinct format string and thread id is written once to the dictionary of the file, so writing
+/// a record is mostly copying of packed arguments and messages are never formatted by the log pattern.
+/// Records are collected in blocks of file_buffer_size bytes from the configuration and written as
+/// DefaultFileLoggerPolicy writes its buffer. Binary logs are rendered back to text by logdecode (see decode_binary_log).
+/// </summary>
+class BinaryFileLoggerPolicy
+{
+public:
+	using concurrent_policy_tag = void;
+	using packed_record_policy_tag = void;
+
+	/// <summary>
+	/// Start appending to the file. Dictionaries start anew.
+	/// </summary>
+	/// <exception cref="std::runtime_error">the file can't be opened</exception>
+	static void set_file_path(const std::filesystem::path& file_path);
+
+	static void configure(const LoggerConfig& config);
+
+	static void release();
+
+	static void write(const LogRecord& record);
+
+	static void flush();
+
+private:
+	struct StringHash
+	{
+		using is_transparent = void;
+
+		size_t operator()(const std::string_view str) const { return std::hash<std::string_view>()(str); }
+	};
+
+	using dictionary_t = std::unordered_map<std::string, uint32_t, StringHash, std::equal_to<>>;
+
+	static void append_unlocked(const LogRecord& record);
+	static uint32_t format_id_unlocked(const std::string_view format);
+	static uint32_t thread_index_unlocked(const std::string_view thread_id);
+	static uint32_t find_or_add_unlocked(dictionary_t& dictionary, BinaryEntryType type, const std::string_view value);
+	static void flush_unlocked();
+	static void flush_if_needed_unlocked();
+
+	static std::mutex mutex_;
+	static std::ofstream file_;
+
+	static std::string block_;  // entries of the current block
+	static BinaryBlockHeader header_;
+	static int64_t last_time_;
+	static bool new_session_;
+
+	// format strings have static storage duration, so their addresses identify them without hashing
+	static std::unordered_map<const char*, uint32_t> format_addresses_;
+	static dictionary_t formats_;
+	static dictionary_t threads_;
+	static std::string last_thread_id_;
+	static uint32_t last_thread_index_;
+
+	static size_t buffer_size_;
+	static std::chrono::milliseconds flush_interval_;
+	static std::chrono::steady_clock::time_point last_flush_;
+};
+
+static_assert(releasable_policy<BinaryFileLoggerPolicy>);
+static_assert(packed_record_policy<BinaryFileLoggerPolicy>);
+static_assert(concurrent_policy<BinaryFileLoggerPolicy>);
+static_assert(configurable_policy<BinaryFileLoggerPolicy>);
+static_assert(flushable_policy<BinaryFileLoggerPolicy>);
+
+} // namespace logger
@@ -0,0 +1,231 @@
+#include "binary_log_decoder.hpp"
+#include "binary_log_reader.hpp"
+#include "log_pattern.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <format>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+using namespace logger;
+
+// blocks decoded by one thread in one round
+constexpr size_t BLOCKS_PER_THREAD = 8;
+
+struct DecodedBlock
+{
+	std::string payload;
+	BinaryLogDictionary dictionary; // entries defined in the block
+	std::vector<BinaryLogRecord> records;
+	bool rendered = false;
+	std::string text;
+};
+
+/// <summary>
+/// Call func(worker, index) for indices from 0 to count by several threads. The first exception is rethrown.
+/// </summary>
+template<class Func>
+void parallel_for(size_t count, size_t threads_count, Func&& func)
+{
+	std::atomic<size_t> next = 0;
+	std::exception_ptr error;
+	std::mutex error_mutex;
+
+	auto worker = [&](size_t worker_index)
+	{
+		try
+		{
+			for (size_t index; (index = next.fetch_add(1)) < count; )
+				func(worker_index, index);
+		}
+		catch (...)
+		{
+			std::scoped_lock lock(error_mutex);
+			if (!error)
+				error = std::current_exception();
+
+			next.store(count);
+		}
+	};
+
+	threads_count = std::min(threads_count, count);
+
+	std::vector<std::thread> threads;
+	for (size_t i = 1; i < threads_count; ++i)
+		threads.emplace_back(worker, i);
+
+	worker(0);
+
+	for (std::thread& thread : threads)
+		thread.join();
+
+	if (error)
+		std::rethrow_exception(error);
+}
+
+void merge_dictionary(std::vector<std::string>& to, const std::vector<std::string>& from)
+{
+	if (to.size() < from.size())
+		to.resize(from.size());
+
+	for (size_t i = 0; i < from.size(); ++i)
+	{
+		if (!from[i].empty())
+			to[i] = from[i];
+	}
+}
+
+} // namespace
+
+namespace logger
+{
+
+BinaryLogDecodeStats decode_binary_log(const fs::path& file_path, const BinaryLogDecodeOptions& options, std::ostream& out)
+{
+	const CompiledLogPattern pattern(options.log_pattern);
+	const DefaultTimeProvider time_provider;
+
+	const std::vector<BinaryLogBlock> blocks = read_binary_log_blocks(file_path);
+	const size_t threads_count = std::max<size_t>(options.threads, 1);
+
+	std::vector<std::ifstream> files(threads_count);
+	for (std::ifstream& file : files)
+	{
+		file.open(file_path, std::ios::binary);
+		if (!file)
+			throw std::runtime_error(std::format("can't open file \"{}\"", file_path.string()));
+	}
+
+	BinaryLogDecodeStats stats;
+	stats.blocks = blocks.size();
+
+	std::atomic<uint64_t> written = 0;
+	std::atomic<uint64_t> errors = 0;
+
+	const auto to_nanoseconds = [](TimeProvider::time_point time)
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+	};
+
+	const int64_t from = options.from == TimeProvider::time_point::min() ? std::numeric_limits<int64_t>::min() : to_nanoseconds(options.from);
+	const int64_t to = options.to == TimeProvider::time_point::max() ? std::numeric_limits<int64_t>::max() : to_nanoseconds(options.to);
+
+	BinaryLogDictionary dictionary;
+
+	std::vector<DecodedBlock> round(threads_count * BLOCKS_PER_THREAD);
+
+	for (size_t first = 0; first < blocks.size(); )
+	{
+		// a round doesn't cross sessions, so its blocks share the dictionary
+		const size_t session = blocks[first].session;
+
+		size_t count = 0;
+		while (count < round.size() && first + count < blocks.size() && blocks[first + count].session == session)
+			++count;
+
+		if (first == 0 || blocks[first - 1].session != session)
+			dictionary = BinaryLogDictionary();
+
+		// parsing: records and dictionary entries of every block
+		parallel_for(count, threads_count, [&](size_t worker, size_t index)
+		{
+			const BinaryLogBlock& block = blocks[first + index];
+			DecodedBlock& decoded = round[index];
+
+			decoded.dictionary.formats.clear();
+			decoded.dictionary.threads.clear();
+			decoded.records.clear();
+			decoded.rendered = block.header.last_time >= from && block.header.first_time < to;
+
+			read_binary_block_payload(files[worker], block, decoded.payload);
+			parse_binary_block(decoded.payload, block.header, decoded.dictionary, decoded.records);
+		});
+
+		// records refer to entries of the same or earlier blocks only, so all of them are known after merging
+		for (size_t index = 0; index < count; ++index)
+		{
+			merge_dictionary(dictionary.formats, round[index].dictionary.formats);
+			merge_dictionary(dictionary.threads, round[index].dictionary.threads);
+
+			stats.records += round[index].records.size();
+			stats.skipped_blocks += round[index].rendered ? 0 : 1;
+		}
+
+		// rendering
+		parallel_for(count, threads_count, [&](size_t, size_t index)
+		{
+			DecodedBlock& decoded = round[index];
+			decoded.text.clear();
+
+			if (!decoded.rendered)
+				return;
+
+			std::string message;
+			char time_buffer[TIME_BUFFER_SIZE];
+
+			for (const BinaryLogRecord& record : decoded.records)
+			{
+				const int64_t time = to_nanoseconds(record.time);
+				if (record.level < options.min_level || time < from || time >= to)
+					continue;
+
+				message.clear();
+				try
+				{
+					format_binary_record(message, record, dictionary);
+				}
+				catch (const std::runtime_error& e)
+				{
+					message = std::format("<{}>", e.what());
+					errors.fetch_add(1, std::memory_order_relaxed);
+				}
+
+				const std::string_view thread_id = record.thread_index < dictionary.threads.size()
+					? std::string_view(dictionary.threads[record.thread_index])
+					: std::string_view("?");
+
+				// a corrupted level byte is rendered and counted like corrupted arguments, so the decoding goes on
+				std::string_view level = "?";
+				if (record.level <= Level::ERROR)
+					level = level_to_str(record.level);
+				else
+					errors.fetch_add(1, std::memory_order_relaxed);
+
+				const size_t time_size = time_provider.format_to(record.time, time_buffer, TIME_BUFFER_SIZE);
+				const pattern_fields_t fields = { std::string_view(time_buffer, time_size), thread_id, level, message };
+
+				pattern.format_to(decoded.text, fields);
+				decoded.text.push_back('\n');
+
+				written.fetch_add(1, std::memory_order_relaxed);
+			}
+		});
+
+		for (size_t index = 0; index < count; ++index)
+			out.write(round[index].text.data(), static_cast<std::streamsize>(round[index].text.size()));
+
+		first += count;
+	}
+
+	if (!out)
+		throw std::runtime_error("can't write decoded log");
+
+	stats.written = written.load();
+	stats.errors = errors.load();
+
+	return stats;
+}
+
+} // namespace logger
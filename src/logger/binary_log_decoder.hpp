@@ -0,0 +1,46 @@
+#pragma once
+
+#include "log_level.hpp"
+#include "logger_config.hpp"
+#include "providers/time_provider.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <string>
+
+namespace logger
+{
+
+struct BinaryLogDecodeOptions
+{
+	std::string log_pattern = std::string(DEFAULT_LOG_PATTERN);
+	Level min_level = Level::DEBUG;
+	TimeProvider::time_point from = TimeProvider::time_point::min(); // records in [from, to) are written
+	TimeProvider::time_point to = TimeProvider::time_point::max();
+	size_t threads = 1;
+};
+
+struct BinaryLogDecodeStats
+{
+	uint64_t blocks = 0;
+	uint64_t skipped_blocks = 0; // out of the time range: parsed for dictionary entries, but not rendered
+	uint64_t records = 0;
+	uint64_t written = 0;
+	uint64_t errors = 0;         // records which format string doesn't match arguments
+};
+
+/// <summary>
+/// Render the binary log (see BinaryFileLoggerPolicy) as text with the log pattern. Records of lower levels
+/// and out of the time range are skipped; blocks out of the time range are not rendered at all.
+/// Blocks are decoded by several threads: rounds of blocks are parsed in parallel, then dictionary entries
+/// are merged in the file order and records are rendered in parallel again, so the output keeps the order.
+/// Time is formatted by DefaultTimeProvider.
+/// </summary>
+/// <exception cref="std::invalid_argument">the log pattern is invalid</exception>
+/// <exception cref="std::runtime_error">the file can't be read or it is corrupted</exception>
+BinaryLogDecodeStats decode_binary_log(const std::filesystem::path& file_path,
+									   const BinaryLogDecodeOptions& options,
+									   std::ostream& out);
+
+} // namespace logger
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace logger
+{
+
+// Binary log file (see BinaryFileLoggerPolicy) is a sequence of blocks:
+//
+//     block:  [BinaryBlockHeader][entries of payload_size bytes]
+//     entry:  [BinaryEntryType][fields]
+//
+//     FORMAT: [varint id][varint size][format string]  - dictionary entry, written before the first record using it
+//     THREAD: [varint index][varint size][thread id]
+//     RECORD: [level][varint time delta][varint thread index][varint format id][varint args size][args]
+//
+// Time delta is zigzag encoded nanoseconds from the previous record of the block (from first_time for the first one).
+// Arguments are packed by pack_args, so they are decoded by tags without original C++ types.
+// Dictionaries are valid from the block with BINARY_BLOCK_NEW_SESSION flag up to the next such block,
+// so blocks of a session could be decoded in parallel once dictionary entries of earlier blocks are known.
+// Numbers are stored in the byte order of the writer (little-endian on supported platforms).
+
+constexpr uint32_t BINARY_BLOCK_MAGIC = 0x4C42474C; // "LGBL"
+constexpr uint8_t BINARY_LOG_VERSION = 2; // 2: 64-bit sizes of packed strings
+
+/// <summary>
+/// Dictionaries start anew from the block: the file was opened by the policy
+/// </summary>
+constexpr uint8_t BINARY_BLOCK_NEW_SESSION = 0x01;
+
+enum class BinaryEntryType : uint8_t
+{
+	FORMAT,
+	THREAD,
+	RECORD
+};
+
+struct BinaryBlockHeader
+{
+	static constexpr size_t SIZE = 32;
+
+	uint32_t magic = BINARY_BLOCK_MAGIC;
+	uint8_t version = BINARY_LOG_VERSION;
+	uint8_t flags = 0;
+	uint32_t payload_size = 0;
+	uint32_t records_count = 0;
+	int64_t first_time = 0; // nanoseconds since the epoch of system_clock
+	int64_t last_time = 0;
+};
+
+namespace internal
+{
+
+template<class T>
+inline void write_binary_field(char*& out, T value)
+{
+	std::memcpy(out, &value, sizeof(value));
+	out += sizeof(value);
+}
+
+template<class T>
+inline T read_binary_field(const char*& in)
+{
+	T value;
+	std::memcpy(&value, in, sizeof(value));
+	in += sizeof(value);
+
+	return value;
+}
+
+} // namespace internal
+
+inline void write_block_header(char (&out)[BinaryBlockHeader::SIZE], const BinaryBlockHeader& header)
+{
+	char* position = out;
+
+	internal::write_binary_field(position, header.magic);
+	internal::write_binary_field(position, header.version);
+	internal::write_binary_field(position, header.flags);
+	internal::write_binary_field(position, uint16_t(0));
+	internal::write_binary_field(position, header.payload_size);
+	internal::write_binary_field(position, header.records_count);
+	internal::write_binary_field(position, header.first_time);
+	internal::write_binary_field(position, header.last_time);
+}
+
+inline BinaryBlockHeader read_block_header(const char (&in)[BinaryBlockHeader::SIZE])
+{
+	const char* position = in;
+	BinaryBlockHeader header;
+
+	header.magic = internal::read_binary_field<uint32_t>(position);
+	header.version = internal::read_binary_field<uint8_t>(position);
+	header.flags = internal::read_binary_field<uint8_t>(position);
+	position += sizeof(uint16_t);
+	header.payload_size = internal::read_binary_field<uint32_t>(position);
+	header.records_count = internal::read_binary_field<uint32_t>(position);
+	header.first_time = internal::read_binary_field<int64_t>(position);
+	header.last_time = internal::read_binary_field<int64_t>(position);
+
+	return header;
+}
+
+/// <summary>
+/// Append unsigned LEB128 number: 7 bits per byte, the high bit is set on all bytes except the last one
+/// </summary>
+inline void append_varint(std::string& out, uint64_t value)
+{
+	while (value >= 0x80)
+	{
+		out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+		value >>= 7;
+	}
+
+	out.push_back(static_cast<char>(value));
+}
+
+/// <summary>
+/// Read the number written by append_varint
+/// </summary>
+/// <returns>false if the number doesn't end before the end of data</returns>
+inline bool read_varint(const char*& in, const char* end, uint64_t& value)
+{
+	value = 0;
+
+	for (unsigned shift = 0; in != end && shift < 64; shift += 7)
+	{
+		const auto byte = static_cast<uint8_t>(*in++);
+		value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+		if ((byte & 0x80) == 0)
+			return true;
+	}
+
+	return false;
+}
+
+constexpr uint64_t zigzag_encode(int64_t value)
+{
+	return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+constexpr int64_t zigzag_decode(uint64_t value)
+{
+	return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+} // namespace logger
@@ -0,0 +1,156 @@
+#include "binary_log_reader.hpp"
+#include "packed_args.hpp"
+
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+void read_dictionary_entry(const char*& in, const char* end, std::vector<std::string>& entries)
+{
+	uint64_t id = 0;
+	uint64_t size = 0;
+
+	if (!logger::read_varint(in, end, id) || !logger::read_varint(in, end, size) || static_cast<uint64_t>(end - in) < size)
+		throw std::runtime_error("binary log dictionary entry is corrupted");
+
+	if (id >= entries.size())
+		entries.resize(static_cast<size_t>(id) + 1);
+
+	entries[static_cast<size_t>(id)].assign(in, static_cast<size_t>(size));
+	in += size;
+}
+
+} // namespace
+
+namespace logger
+{
+
+std::vector<BinaryLogBlock> read_binary_log_blocks(const fs::path& file_path)
+{
+	std::ifstream file(file_path, std::ios::binary);
+	if (!file)
+		throw std::runtime_error(std::format("can't open file \"{}\"", file_path.string()));
+
+	std::error_code error;
+	const uint64_t file_size = static_cast<uint64_t>(fs::file_size(file_path, error));
+	if (error)
+		throw std::runtime_error(std::format("can't get size of file \"{}\": {}", file_path.string(), error.message()));
+
+	std::vector<BinaryLogBlock> blocks;
+	uint64_t offset = 0;
+	size_t session = 0;
+
+	while (offset + BinaryBlockHeader::SIZE <= file_size)
+	{
+		char buffer[BinaryBlockHeader::SIZE];
+
+		file.seekg(static_cast<std::streamoff>(offset));
+		if (!file.read(buffer, sizeof(buffer)))
+			throw std::runtime_error(std::format("can't read file \"{}\"", file_path.string()));
+
+		BinaryLogBlock block;
+		block.header = read_block_header(buffer);
+		block.offset = offset + BinaryBlockHeader::SIZE;
+
+		if (block.header.magic != BINARY_BLOCK_MAGIC || block.header.version != BINARY_LOG_VERSION)
+			throw std::runtime_error(std::format("\"{}\" is not a binary log (offset {})", file_path.string(), offset));
+
+		if (block.offset + block.header.payload_size > file_size)
+			break;
+
+		if ((block.header.flags & BINARY_BLOCK_NEW_SESSION) && !blocks.empty())
+			++session;
+
+		block.session = session;
+		blocks.push_back(block);
+
+		offset = block.offset + block.header.payload_size;
+	}
+
+	return blocks;
+}
+
+void read_binary_block_payload(std::istream& file, const BinaryLogBlock& block, std::string& payload)
+{
+	payload.resize(block.header.payload_size);
+
+	file.seekg(static_cast<std::streamoff>(block.offset));
+	if (!file.read(payload.data(), static_cast<std::streamsize>(payload.size())))
+		throw std::runtime_error(std::format("can't read binary log block at offset {}", block.offset));
+}
+
+void parse_binary_block(std::string_view payload,
+						const BinaryBlockHeader& header,
+						BinaryLogDictionary& dictionary,
+						std::vector<BinaryLogRecord>& records)
+{
+	const char* in = payload.data();
+	const char* const end = in + payload.size();
+	int64_t time = header.first_time;
+
+	while (in != end)
+	{
+		const auto type = static_cast<BinaryEntryType>(*in++);
+
+		if (type == BinaryEntryType::FORMAT)
+		{
+			read_dictionary_entry(in, end, dictionary.formats);
+			continue;
+		}
+
+		if (type == BinaryEntryType::THREAD)
+		{
+			read_dictionary_entry(in, end, dictionary.threads);
+			continue;
+		}
+
+		if (type != BinaryEntryType::RECORD || in == end)
+			throw std::runtime_error("binary log block is corrupted");
+
+		BinaryLogRecord record;
+		record.level = static_cast<Level>(static_cast<uint8_t>(*in++));
+
+		uint64_t delta = 0;
+		uint64_t thread_index = 0;
+		uint64_t format_id = 0;
+		uint64_t args_size = 0;
+
+		if (!read_varint(in, end, delta) || !read_varint(in, end, thread_index) || !read_varint(in, end, format_id)
+			|| !read_varint(in, end, args_size) || static_cast<uint64_t>(end - in) < args_size)
+		{
+			throw std::runtime_error("binary log record is corrupted");
+		}
+
+		time += zigzag_decode(delta);
+
+		record.time = TimeProvider::time_point(std::chrono::duration_cast<TimeProvider::time_point::duration>(std::chrono::nanoseconds(time)));
+		record.thread_index = static_cast<uint32_t>(thread_index);
+		record.format_id = static_cast<uint32_t>(format_id);
+		record.args = { reinterpret_cast<const std::byte*>(in), static_cast<size_t>(args_size) };
+		in += args_size;
+
+		records.push_back(record);
+	}
+}
+
+void format_binary_record(std::string& out, const BinaryLogRecord& record, const BinaryLogDictionary& dictionary)
+{
+	if (record.format_id >= dictionary.formats.size())
+		throw std::runtime_error(std::format("unknown format string id {}", record.format_id));
+
+	try
+	{
+		format_tagged_args(out, dictionary.formats[record.format_id], record.args);
+	}
+	catch (const std::format_error& e)
+	{
+		throw std::runtime_error(std::format("can't format \"{}\": {}", dictionary.formats[record.format_id], e.what()));
+	}
+}
+
+} // namespace logger
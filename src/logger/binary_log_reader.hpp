@@ -0,0 +1,79 @@
+#pragma once
+
+#include "binary_log_format.hpp"
+#include "log_level.hpp"
+#include "providers/time_provider.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace logger
+{
+
+/// <summary>
+/// Block of the binary log file
+/// </summary>
+struct BinaryLogBlock
+{
+	uint64_t offset = 0; // of the payload in the file
+	BinaryBlockHeader header;
+	size_t session = 0;  // blocks share dictionaries within the session (see BINARY_BLOCK_NEW_SESSION)
+};
+
+/// <summary>
+/// Format strings and thread ids of one session of the binary log, indexed by their ids
+/// </summary>
+struct BinaryLogDictionary
+{
+	std::vector<std::string> formats;
+	std::vector<std::string> threads;
+};
+
+/// <summary>
+/// Record of the binary log, args refer to the block payload
+/// </summary>
+struct BinaryLogRecord
+{
+	TimeProvider::time_point time;
+	Level level = Level::DEBUG;
+	uint32_t thread_index = 0;
+	uint32_t format_id = 0;
+	std::span<const std::byte> args;
+};
+
+/// <summary>
+/// Read headers of all blocks of the file skipping their payloads. The unfinished last block
+/// (the writer was stopped while writing it) is ignored.
+/// </summary>
+/// <exception cref="std::runtime_error">the file can't be read or it is not a binary log</exception>
+std::vector<BinaryLogBlock> read_binary_log_blocks(const std::filesystem::path& file_path);
+
+/// <summary>
+/// Read the payload of the block from the file
+/// </summary>
+/// <exception cref="std::runtime_error">the payload can't be read</exception>
+void read_binary_block_payload(std::istream& file, const BinaryLogBlock& block, std::string& payload);
+
+/// <summary>
+/// Parse entries of the block: dictionary entries are added to the dictionary, records are appended to records.
+/// Records refer to the payload.
+/// </summary>
+/// <exception cref="std::runtime_error">the payload is corrupted</exception>
+void parse_binary_block(std::string_view payload,
+						const BinaryBlockHeader& header,
+						BinaryLogDictionary& dictionary,
+						std::vector<BinaryLogRecord>& records);
+
+/// <summary>
+/// Append the message of the record formatted by its format string from the dictionary
+/// </summary>
+/// <exception cref="std::runtime_error">the format string is unknown or doesn't match arguments</exception>
+void format_binary_record(std::string& out, const BinaryLogRecord& record, const BinaryLogDictionary& dictionary);
+
+} // namespace logger
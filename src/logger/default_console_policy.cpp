@@ -10,4 +10,12 @@ void DefaultConsoleLoggerPolicy::write(const std::string_view message)
 	std::cout << message << std::endl;
 }
 
+void DefaultConsoleLoggerPolicy::write_batch(const std::span<const std::string_view> messages)
+{
+	for (const std::string_view message : messages)
+		std::cout << message << '\n';
+
+	std::cout.flush();
+}
+
 } // namespace logger
@@ -1,5 +1,6 @@
 ﻿#pragma once
 
+#include <span>
 #include <string_view>
 
 namespace logger
@@ -8,6 +9,7 @@ namespace logger
 struct DefaultConsoleLoggerPolicy
 {
 	static void write(const std::string_view);
+	static void write_batch(const std::span<const std::string_view> messages);
 };
 
 } // namespace logger
@@ -1,10 +1,55 @@
 #include "default_file_policy.hpp"
 
+#include <thread>
+
 namespace logger
 {
 
+/// <summary>
+/// Owner of the flusher thread. It is destroyed before other static members of the policy and stops the thread,
+/// so the process exits normally even if release() is never called.
+/// </summary>
+class DefaultFileLoggerPolicy::Flusher
+{
+public:
+	~Flusher()
+	{
+		stop();
+	}
+
+	void start()
+	{
+		thread_ = std::thread(&DefaultFileLoggerPolicy::flush_loop);
+	}
+
+	void stop()
+	{
+		{
+			std::scoped_lock lock(log_file_mutex_);
+			stop_ = true;
+		}
+
+		flush_cv_.notify_all();
+
+		if (thread_.joinable())
+			thread_.join();
+	}
+
+private:
+	std::thread thread_;
+};
+
 std::ofstream DefaultFileLoggerPolicy::log_file_;
 std::mutex DefaultFileLoggerPolicy::log_file_mutex_;
+std::condition_variable DefaultFileLoggerPolicy::flush_cv_;
+
+std::string DefaultFileLoggerPolicy::buffer_;
+size_t DefaultFileLoggerPolicy::buffer_size_ = DEFAULT_FILE_BUFFER_SIZE;
+std::chrono::milliseconds DefaultFileLoggerPolicy::flush_interval_ = DEFAULT_FLUSH_INTERVAL;
+std::chrono::steady_clock::time_point DefaultFileLoggerPolicy::last_flush_;
+
+bool DefaultFileLoggerPolicy::stop_ = false;
+DefaultFileLoggerPolicy::Flusher DefaultFileLoggerPolicy::flusher_;
 
 void DefaultFileLoggerPolicy::set_file_path(const std::string_view file_path)
 {
@@ -12,12 +57,33 @@ void DefaultFileLoggerPolicy::set_file_path(const std::string_view file_path)
 
 	std::scoped_lock lock(log_file_mutex_);
 	log_file_.open(std::string(file_path), std::ios::out | std::ios::app);
+	last_flush_ = std::chrono::steady_clock::now();
+
+	stop_ = false;
+	flusher_.start();
+}
+
+void DefaultFileLoggerPolicy::configure(const LoggerConfig& config)
+{
+	std::scoped_lock lock(log_file_mutex_);
+
+	flush_unlocked();
+
+	buffer_size_ = config.file_buffer_size;
+	flush_interval_ = config.flush_interval;
+	buffer_.reserve(buffer_size_);
+
+	flush_cv_.notify_all();
 }
 
 void DefaultFileLoggerPolicy::release()
 {
+	flusher_.stop();
+
 	std::scoped_lock lock(log_file_mutex_);
 
+	flush_unlocked();
+
 	if (log_file_.is_open())
 		log_file_.close();
 }
@@ -29,7 +95,78 @@ void DefaultFileLoggerPolicy::write(const std::string_view message)
 	if (!log_file_.is_open())
 		return;
 
-	log_file_ << message << std::endl;
+	buffer_.append(message);
+	buffer_.push_back('\n');
+
+	flush_if_needed_unlocked();
+}
+
+void DefaultFileLoggerPolicy::write_batch(const std::span<const std::string_view> messages)
+{
+	std::scoped_lock lock(log_file_mutex_);
+
+	if (!log_file_.is_open())
+		return;
+
+	for (const std::string_view message : messages)
+	{
+		buffer_.append(message);
+		buffer_.push_back('\n');
+	}
+
+	flush_if_needed_unlocked();
+}
+
+void DefaultFileLoggerPolicy::flush()
+{
+	std::scoped_lock lock(log_file_mutex_);
+
+	flush_unlocked();
+}
+
+void DefaultFileLoggerPolicy::flush_unlocked()
+{
+	if (!buffer_.empty() && log_file_.is_open())
+	{
+		log_file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+		log_file_.flush();
+	}
+
+	buffer_.clear();
+	last_flush_ = std::chrono::steady_clock::now();
+}
+
+void DefaultFileLoggerPolicy::flush_if_needed_unlocked()
+{
+	if (buffer_.size() >= buffer_size_)
+	{
+		flush_unlocked();
+		return;
+	}
+
+	if (flush_interval_.count() > 0 && std::chrono::steady_clock::now() - last_flush_ >= flush_interval_)
+		flush_unlocked();
+}
+
+void DefaultFileLoggerPolicy::flush_loop()
+{
+	std::unique_lock lock(log_file_mutex_);
+
+	while (!stop_)
+	{
+		// without buffering or the interval there is nothing to wait for until configure() or release()
+		if (buffer_size_ == 0 || flush_interval_.count() <= 0)
+		{
+			flush_cv_.wait(lock);
+			continue;
+		}
+
+		const std::chrono::steady_clock::time_point deadline = last_flush_ + flush_interval_;
+		if (std::chrono::steady_clock::now() >= deadline)
+			flush_unlocked();
+		else
+			flush_cv_.wait_until(lock, deadline);
+	}
 }
 
 } // namespace logger
@@ -1,7 +1,12 @@
 ﻿#pragma once
 
 #include "logger_concepts.hpp"
+#include "logger_config.hpp"
 
+#include <chrono>
+#include <condition_variable>
+#include <span>
+#include <string>
 #include <string_view>
 #include <iostream>
 #include <fstream>
@@ -10,20 +15,53 @@
 namespace logger
 {
 
+/// <summary>
+/// Thread-safe file policy: the file stream is guarded by its own mutex.
+/// Entries are collected in the buffer of file_buffer_size bytes from the configuration and written
+/// when the buffer is full, when flush_interval passed since the previous flush (checked on writes and
+/// by the flusher thread, so entries don't stay in the buffer when nothing else is logged),
+/// on flush() call (loggers call it after entries of flush_level and higher) and on release().
+/// </summary>
 class DefaultFileLoggerPolicy
 {
 public:
+	using concurrent_policy_tag = void;
+
 	static void set_file_path(const std::string_view file_path);
 
+	static void configure(const LoggerConfig& config);
+
 	static void release();
 
 	static void write(const std::string_view message);
+	static void write_batch(const std::span<const std::string_view> messages);
+
+	static void flush();
 
 private:
+	class Flusher;
+
+	static void flush_unlocked();
+	static void flush_if_needed_unlocked();
+	static void flush_loop();
+
 	static std::ofstream log_file_;
 	static std::mutex log_file_mutex_;
+	static std::condition_variable flush_cv_;
+
+	static std::string buffer_;
+	static size_t buffer_size_;
+	static std::chrono::milliseconds flush_interval_;
+	static std::chrono::steady_clock::time_point last_flush_;
+
+	static bool stop_;
+	static Flusher flusher_;
 };
 
 static_assert(releasable_policy<DefaultFileLoggerPolicy>);
+static_assert(batch_policy<DefaultFileLoggerPolicy>);
+static_assert(concurrent_policy<DefaultFileLoggerPolicy>);
+static_assert(configurable_policy<DefaultFileLoggerPolicy>);
+static_assert(flushable_policy<DefaultFileLoggerPolicy>);
 
 } // namespace logger
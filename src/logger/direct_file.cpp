@@ -0,0 +1,196 @@
+#include "direct_file.hpp"
+
+#include <format>
+#include <stdexcept>
+#include <string>
+
+#if defined(_WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#define NOGDI
+	#include <windows.h>
+#else
+	#include <cerrno>
+	#include <cstring>
+	#include <fcntl.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace logger
+{
+
+DirectFile::~DirectFile()
+{
+	close();
+}
+
+#if defined(_WIN32)
+
+void DirectFile::open(const std::filesystem::path& path)
+{
+	close();
+
+	constexpr DWORD access = GENERIC_READ | GENERIC_WRITE;
+
+	HANDLE file = CreateFileW(path.c_str(), access, FILE_SHARE_READ, nullptr, OPEN_ALWAYS,
+							  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_NO_BUFFERING, nullptr);
+	direct_ = file != INVALID_HANDLE_VALUE;
+
+	if (!direct_)
+		file = CreateFileW(path.c_str(), access, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (file == INVALID_HANDLE_VALUE)
+		throw std::runtime_error(std::format("can't open file \"{}\": error {}", path.string(), GetLastError()));
+
+	file_ = file;
+}
+
+void DirectFile::close()
+{
+	if (!is_open())
+		return;
+
+	CloseHandle(file_);
+	file_ = nullptr;
+	direct_ = false;
+}
+
+bool DirectFile::is_open() const
+{
+	return file_ != nullptr;
+}
+
+size_t DirectFile::size() const
+{
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file_, &size))
+		throw std::runtime_error(std::format("can't get file size: error {}", GetLastError()));
+
+	return static_cast<size_t>(size.QuadPart);
+}
+
+size_t DirectFile::read_at(char* data, size_t size, size_t offset) const
+{
+	OVERLAPPED position {};
+	position.Offset = static_cast<DWORD>(offset);
+	position.OffsetHigh = static_cast<DWORD>(static_cast<ULONGLONG>(offset) >> 32);
+
+	DWORD read = 0;
+	if (!ReadFile(file_, data, static_cast<DWORD>(size), &read, &position) && GetLastError() != ERROR_HANDLE_EOF)
+		throw std::runtime_error(std::format("can't read file: error {}", GetLastError()));
+
+	return read;
+}
+
+void DirectFile::write_at(const char* data, size_t size, size_t offset) const
+{
+	OVERLAPPED position {};
+	position.Offset = static_cast<DWORD>(offset);
+	position.OffsetHigh = static_cast<DWORD>(static_cast<ULONGLONG>(offset) >> 32);
+
+	DWORD written = 0;
+	if (!WriteFile(file_, data, static_cast<DWORD>(size), &written, &position) || written != size)
+		throw std::runtime_error(std::format("can't write {} bytes to file: error {}", size, GetLastError()));
+}
+
+void DirectFile::truncate(size_t size) const
+{
+	FILE_END_OF_FILE_INFO info {};
+	info.EndOfFile.QuadPart = static_cast<LONGLONG>(size);
+
+	if (!SetFileInformationByHandle(file_, FileEndOfFileInfo, &info, sizeof(info)))
+		throw std::runtime_error(std::format("can't truncate file: error {}", GetLastError()));
+}
+
+#else
+
+void DirectFile::open(const std::filesystem::path& path)
+{
+	close();
+
+	constexpr int flags = O_RDWR | O_CREAT | O_CLOEXEC;
+
+#if defined(O_DIRECT)
+	// tmpfs and some other file systems reject O_DIRECT
+	int fd = ::open(path.c_str(), flags | O_DIRECT, 0644);
+	direct_ = fd >= 0;
+
+	if (!direct_ && errno == EINVAL)
+		fd = ::open(path.c_str(), flags, 0644);
+#else
+	int fd = ::open(path.c_str(), flags, 0644);
+
+	#if defined(F_NOCACHE)
+	direct_ = fd >= 0 && ::fcntl(fd, F_NOCACHE, 1) == 0;
+	#endif
+#endif
+
+	if (fd < 0)
+		throw std::runtime_error(std::format("can't open file \"{}\": {}", path.string(), std::strerror(errno)));
+
+	fd_ = fd;
+}
+
+void DirectFile::close()
+{
+	if (!is_open())
+		return;
+
+	::close(fd_);
+	fd_ = -1;
+	direct_ = false;
+}
+
+bool DirectFile::is_open() const
+{
+	return fd_ >= 0;
+}
+
+size_t DirectFile::size() const
+{
+	struct stat info;
+	if (::fstat(fd_, &info) != 0)
+		throw std::runtime_error(std::format("can't get file size: {}", std::strerror(errno)));
+
+	return static_cast<size_t>(info.st_size);
+}
+
+size_t DirectFile::read_at(char* data, size_t size, size_t offset) const
+{
+	for (;;)
+	{
+		const ssize_t result = ::pread(fd_, data, size, static_cast<off_t>(offset));
+		if (result >= 0)
+			return static_cast<size_t>(result);
+
+		if (errno != EINTR)
+			throw std::runtime_error(std::format("can't read file: {}", std::strerror(errno)));
+	}
+}
+
+void DirectFile::write_at(const char* data, size_t size, size_t offset) const
+{
+	size_t written = 0;
+	while (written < size)
+	{
+		const ssize_t result = ::pwrite(fd_, data + written, size - written, static_cast<off_t>(offset + written));
+		if (result < 0 && errno == EINTR)
+			continue;
+
+		if (result <= 0)
+			throw std::runtime_error(std::format("can't write {} bytes to file: {}", size - written, result < 0 ? std::strerror(errno) : "no space"));
+
+		written += static_cast<size_t>(result);
+	}
+}
+
+void DirectFile::truncate(size_t size) const
+{
+	if (::ftruncate(fd_, static_cast<off_t>(size)) != 0)
+		throw std::runtime_error(std::format("can't truncate file: {}", std::strerror(errno)));
+}
+
+#endif
+
+} // namespace logger
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+namespace logger
+{
+
+/// <summary>
+/// File opened for unbuffered I/O bypassing the page cache (O_DIRECT on Linux, FILE_FLAG_NO_BUFFERING on Windows).
+/// Offsets, sizes and memory of reads and writes must be aligned to BLOCK_SIZE. If the file system doesn't
+/// support unbuffered I/O, the file is opened for ordinary I/O (see is_direct).
+/// </summary>
+class DirectFile
+{
+public:
+	static constexpr size_t BLOCK_SIZE = 4096;
+
+	DirectFile() = default;
+	~DirectFile();
+
+	DirectFile(DirectFile&&) = delete;
+	DirectFile& operator=(DirectFile&&) = delete;
+	DirectFile(const DirectFile&) = delete;
+	DirectFile& operator=(const DirectFile&) = delete;
+
+	/// <summary>
+	/// Open or create the file for reading and writing
+	/// </summary>
+	/// <exception cref="std::runtime_error">file can't be opened</exception>
+	void open(const std::filesystem::path& path);
+
+	void close();
+
+	bool is_open() const;
+	bool is_direct() const { return direct_; }
+
+	/// <summary>
+	/// Current size of the file
+	/// </summary>
+	size_t size() const;
+
+	/// <summary>
+	/// Read up to size bytes at offset, returns the number of bytes read (less at the end of the file)
+	/// </summary>
+	/// <exception cref="std::runtime_error">read error</exception>
+	size_t read_at(char* data, size_t size, size_t offset) const;
+
+	/// <exception cref="std::runtime_error">write error</exception>
+	void write_at(const char* data, size_t size, size_t offset) const;
+
+	/// <summary>
+	/// Set the file size, e.g. to cut padding of the last block
+	/// </summary>
+	/// <exception cref="std::runtime_error">the size can't be changed</exception>
+	void truncate(size_t size) const;
+
+private:
+	bool direct_ = false;
+
+#if defined(_WIN32)
+	void* file_ = nullptr;
+#else
+	int fd_ = -1;
+#endif
+};
+
+} // namespace logger
@@ -0,0 +1,225 @@
+#include "direct_file_policy.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+using logger::DirectFile;
+
+constexpr size_t align_down(size_t size)
+{
+	return size & ~(DirectFile::BLOCK_SIZE - 1);
+}
+
+constexpr size_t align_up(size_t size)
+{
+	return align_down(size + DirectFile::BLOCK_SIZE - 1);
+}
+
+} // namespace
+
+namespace logger
+{
+
+DirectFile DirectFileLoggerPolicy::file_;
+
+std::mutex DirectFileLoggerPolicy::mutex_;
+std::condition_variable DirectFileLoggerPolicy::cv_;
+
+std::array<DirectFileLoggerPolicy::buffer_t, 2> DirectFileLoggerPolicy::buffers_;
+size_t DirectFileLoggerPolicy::active_ = 0;
+size_t DirectFileLoggerPolicy::active_size_ = 0;
+size_t DirectFileLoggerPolicy::active_offset_ = 0;
+bool DirectFileLoggerPolicy::unflushed_ = false;
+
+DirectFileLoggerPolicy::PendingWrite DirectFileLoggerPolicy::pending_;
+bool DirectFileLoggerPolicy::writing_ = false;
+bool DirectFileLoggerPolicy::stop_ = false;
+std::thread DirectFileLoggerPolicy::writer_;
+
+void DirectFileLoggerPolicy::set_file_path(const fs::path& file_path)
+{
+	release();
+
+	std::scoped_lock lock(mutex_);
+
+	for (buffer_t& buffer : buffers_)
+	{
+		if (!buffer)
+			buffer.reset(new (std::align_val_t(DirectFile::BLOCK_SIZE)) char[DIRECT_BUFFER_SIZE]);
+	}
+
+	file_.open(file_path);
+
+	try
+	{
+		// the unaligned tail of the existing file is rewritten together with new entries
+		const size_t file_size = file_.size();
+
+		active_ = 0;
+		active_offset_ = align_down(file_size);
+		active_size_ = file_size == active_offset_ ? 0 : file_.read_at(buffers_[active_].get(), DirectFile::BLOCK_SIZE, active_offset_);
+		unflushed_ = false;
+	}
+	catch (...)
+	{
+		file_.close();
+		throw;
+	}
+
+	writer_ = std::thread(&DirectFileLoggerPolicy::writer_loop);
+}
+
+bool DirectFileLoggerPolicy::is_direct()
+{
+	std::scoped_lock lock(mutex_);
+	return file_.is_direct();
+}
+
+void DirectFileLoggerPolicy::release()
+{
+	std::unique_lock lock(mutex_);
+
+	if (!file_.is_open())
+		return;
+
+	cv_.wait(lock, []() { return !writing_; });
+
+	if (unflushed_)
+		submit_active_unlocked();
+
+	// writes are not accepted any more, the writer finishes the pending write and exits
+	stop_ = true;
+	cv_.notify_all();
+	lock.unlock();
+
+	writer_.join();
+
+	lock.lock();
+
+	file_.close();
+	active_size_ = 0;
+	unflushed_ = false;
+	stop_ = false;
+}
+
+void DirectFileLoggerPolicy::write(const std::string_view message)
+{
+	std::unique_lock lock(mutex_);
+	append_unlocked(lock, message);
+}
+
+void DirectFileLoggerPolicy::write_batch(const std::span<const std::string_view> messages)
+{
+	std::unique_lock lock(mutex_);
+
+	for (const std::string_view message : messages)
+		append_unlocked(lock, message);
+}
+
+void DirectFileLoggerPolicy::flush()
+{
+	std::unique_lock lock(mutex_);
+
+	cv_.wait(lock, []() { return !writing_ || stop_; });
+
+	if (unflushed_ && !stop_ && file_.is_open())
+		submit_active_unlocked();
+}
+
+void DirectFileLoggerPolicy::append_unlocked(std::unique_lock<std::mutex>& lock, const std::string_view message)
+{
+	// the rest of the entry always fits the next buffer, so the entry is never interleaved with others
+	const std::string_view line = message.substr(0, DIRECT_BUFFER_SIZE - DirectFile::BLOCK_SIZE - 1);
+	const size_t size = line.size() + 1;
+
+	// the buffer filled by the entry is submitted at once, so the other one must be written by then
+	cv_.wait(lock, [size]() { return active_size_ + size < DIRECT_BUFFER_SIZE || !writing_ || stop_; });
+
+	if (stop_ || !file_.is_open())
+		return;
+
+	unflushed_ = true;
+
+	put_unlocked(line);
+	put_unlocked("\n");
+}
+
+void DirectFileLoggerPolicy::put_unlocked(std::string_view part)
+{
+	while (!part.empty())
+	{
+		const size_t size = std::min(part.size(), DIRECT_BUFFER_SIZE - active_size_);
+
+		std::memcpy(buffers_[active_].get() + active_size_, part.data(), size);
+		active_size_ += size;
+		part.remove_prefix(size);
+
+		if (active_size_ == DIRECT_BUFFER_SIZE)
+			submit_active_unlocked();
+	}
+}
+
+void DirectFileLoggerPolicy::submit_active_unlocked()
+{
+	char* const buffer = buffers_[active_].get();
+
+	const size_t aligned_size = align_up(active_size_);
+	const size_t tail_offset = align_down(active_size_);
+	const size_t tail_size = active_size_ - tail_offset;
+
+	std::memset(buffer + active_size_, 0, aligned_size - active_size_);
+
+	pending_ = { active_, aligned_size, active_offset_, active_offset_ + active_size_ };
+	writing_ = true;
+
+	// the unaligned tail goes to the next buffer and is written again at the same offset
+	active_ ^= 1;
+	std::memcpy(buffers_[active_].get(), buffer + tail_offset, tail_size);
+	active_size_ = tail_size;
+	active_offset_ += tail_offset;
+	unflushed_ = false;
+
+	cv_.notify_all();
+}
+
+void DirectFileLoggerPolicy::writer_loop()
+{
+	std::unique_lock lock(mutex_);
+
+	for (;;)
+	{
+		cv_.wait(lock, []() { return writing_ || stop_; });
+
+		if (!writing_)
+			return;
+
+		const PendingWrite write = pending_;
+		lock.unlock();
+
+		try
+		{
+			file_.write_at(buffers_[write.buffer].get(), write.size, write.offset);
+
+			// cut the padding of the last block
+			if (write.offset + write.size != write.file_end)
+				file_.truncate(write.file_end);
+		}
+		catch (const std::exception& e)
+		{
+			std::cerr << "Error: " << e.what() << std::endl;
+		}
+
+		lock.lock();
+		writing_ = false;
+		cv_.notify_all();
+	}
+}
+
+} // namespace logger
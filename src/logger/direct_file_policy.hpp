@@ -0,0 +1,100 @@
+#pragma once
+
+#include "logger_concepts.hpp"
+#include "direct_file.hpp"
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <span>
+#include <string_view>
+#include <thread>
+
+namespace logger
+{
+
+/// <summary>
+/// File policy that writes through O_DIRECT (see DirectFile), so log data doesn't evict hot pages from the page cache.
+/// Entries are collected in two aligned buffers: one is filled while the writer thread writes the other.
+/// On flush() (loggers call it after entries of flush_level and higher) and on release() the unaligned tail
+/// is written padded to the whole block and the file is truncated to its real size; the tail stays
+/// in the buffer and is written again with the following entries.
+/// </summary>
+class DirectFileLoggerPolicy
+{
+public:
+	using concurrent_policy_tag = void;
+
+	static constexpr size_t DIRECT_BUFFER_SIZE = 1024 * 1024;
+
+	/// <summary>
+	/// Start appending to the file
+	/// </summary>
+	/// <exception cref="std::runtime_error">the file can't be opened or its tail can't be read</exception>
+	static void set_file_path(const std::filesystem::path& file_path);
+
+	/// <summary>
+	/// False if the file system doesn't support unbuffered I/O and the page cache is used
+	/// </summary>
+	static bool is_direct();
+
+	/// <summary>
+	/// Write the rest of the entries with the final block padded, truncate the file and close it
+	/// </summary>
+	static void release();
+
+	static void write(const std::string_view message);
+	static void write_batch(const std::span<const std::string_view> messages);
+
+	static void flush();
+
+private:
+	static_assert(DIRECT_BUFFER_SIZE % DirectFile::BLOCK_SIZE == 0);
+
+	struct AlignedDelete
+	{
+		void operator()(char* buffer) const { ::operator delete[](buffer, std::align_val_t(DirectFile::BLOCK_SIZE)); }
+	};
+
+	using buffer_t = std::unique_ptr<char[], AlignedDelete>;
+
+	struct PendingWrite
+	{
+		size_t buffer = 0;
+		size_t size = 0;     // padded to the whole block
+		size_t offset = 0;
+		size_t file_end = 0; // real end of the data
+	};
+
+	static void append_unlocked(std::unique_lock<std::mutex>& lock, const std::string_view message);
+	static void put_unlocked(std::string_view part);
+	static void submit_active_unlocked();
+	static void writer_loop();
+
+	static DirectFile file_;
+
+	static std::mutex mutex_;
+	static std::condition_variable cv_;
+
+	static std::array<buffer_t, 2> buffers_;
+	static size_t active_;
+	static size_t active_size_;
+	static size_t active_offset_; // block aligned file offset of the active buffer
+	static bool unflushed_;
+
+	static PendingWrite pending_;
+	static bool writing_;
+	static bool stop_;
+	static std::thread writer_;
+};
+
+static_assert(releasable_policy<DirectFileLoggerPolicy>);
+static_assert(batch_policy<DirectFileLoggerPolicy>);
+static_assert(concurrent_policy<DirectFileLoggerPolicy>);
+static_assert(flushable_policy<DirectFileLoggerPolicy>);
+
+} // namespace logger
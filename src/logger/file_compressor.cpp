@@ -0,0 +1,169 @@
+#include "file_compressor.hpp"
+#include "gzip_file.hpp"
+
+#include <exception>
+#include <iostream>
+#include <system_error>
+
+#if defined(_WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#define NOGDI
+	#include <windows.h>
+#elif defined(__linux__)
+	#include <sys/resource.h>
+	#include <sys/syscall.h>
+	#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+void lower_this_thread_priority()
+{
+#if defined(_WIN32)
+	SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_LOWEST);
+#elif defined(__linux__)
+	// nice value of the thread only (Linux threads have their own)
+	(void) setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 10);
+#endif
+}
+
+} // namespace
+
+namespace logger
+{
+
+FileCompressor::~FileCompressor()
+{
+	stop();
+}
+
+void FileCompressor::start(size_t threads_count, int level)
+{
+	std::scoped_lock lock(mutex_);
+
+	if (!threads_.empty())
+		return;
+
+	level_ = level;
+	stop_ = false;
+
+	for (size_t i = 0; i < threads_count; ++i)
+		threads_.emplace_back(&FileCompressor::worker_loop, this);
+}
+
+void FileCompressor::stop()
+{
+	std::vector<std::thread> threads;
+
+	{
+		std::scoped_lock lock(mutex_);
+
+		stop_ = true;
+		threads.swap(threads_);
+	}
+
+	cv_.notify_all();
+
+	for (std::thread& thread : threads)
+		thread.join();
+}
+
+void FileCompressor::submit(fs::path path, callback_t callback)
+{
+	{
+		std::scoped_lock lock(mutex_);
+		queue_.push_back({ std::move(path), std::move(callback) });
+	}
+
+	cv_.notify_one();
+}
+
+CompressionStats FileCompressor::stats() const
+{
+	CompressionStats result;
+
+	{
+		std::scoped_lock lock(mutex_);
+		result.pending = queue_.size() + active_;
+	}
+
+	result.compressed = compressed_.load(std::memory_order_relaxed);
+	result.failed = failed_.load(std::memory_order_relaxed);
+	result.bytes_in = bytes_in_.load(std::memory_order_relaxed);
+	result.bytes_out = bytes_out_.load(std::memory_order_relaxed);
+
+	return result;
+}
+
+fs::path FileCompressor::compressed_path(const fs::path& path)
+{
+	fs::path result = path;
+	result += ".gz";
+
+	return result;
+}
+
+void FileCompressor::worker_loop()
+{
+	lower_this_thread_priority();
+
+	std::unique_lock lock(mutex_);
+
+	for (;;)
+	{
+		cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+
+		// submitted files are compressed before stop
+		if (queue_.empty())
+			return;
+
+		const Job job = std::move(queue_.front());
+		queue_.pop_front();
+		++active_;
+
+		const int level = level_;
+		lock.unlock();
+
+		const fs::path result = compress(job.path, level);
+		if (job.callback)
+			job.callback(result);
+
+		lock.lock();
+		--active_;
+	}
+}
+
+fs::path FileCompressor::compress(const fs::path& path, int level)
+{
+	const fs::path result = compressed_path(path);
+	std::error_code error;
+
+	try
+	{
+		const uint64_t source_size = static_cast<uint64_t>(fs::file_size(path));
+		const uint64_t result_size = gzip_file(path, result, level);
+
+		fs::remove(path, error);
+
+		bytes_in_.fetch_add(source_size, std::memory_order_relaxed);
+		bytes_out_.fetch_add(result_size, std::memory_order_relaxed);
+		compressed_.fetch_add(1, std::memory_order_relaxed);
+
+		return result;
+	}
+	catch (const std::exception& e)
+	{
+		fs::remove(result, error);
+		failed_.fetch_add(1, std::memory_order_relaxed);
+
+		std::cerr << "Error: " << e.what() << std::endl;
+
+		return path;
+	}
+}
+
+} // namespace logger
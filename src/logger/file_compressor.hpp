@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace logger
+{
+
+/// <summary>
+/// Progress of FileCompressor
+/// </summary>
+struct CompressionStats
+{
+	uint64_t pending = 0;    // files waiting for compression or being compressed
+	uint64_t compressed = 0;
+	uint64_t failed = 0;
+	uint64_t bytes_in = 0;   // total size of compressed files
+	uint64_t bytes_out = 0;  // total size of the results
+};
+
+/// <summary>
+/// Pool of low priority threads compressing files to gzip (see gzip_file). "file.log" is compressed
+/// to "file.log.gz" and removed; if compression fails, the file is kept.
+/// </summary>
+class FileCompressor
+{
+public:
+	/// <summary>
+	/// Called by the compressing thread with the path of the result: the compressed file, or the source one if compression failed
+	/// </summary>
+	using callback_t = std::function<void(const std::filesystem::path& result)>;
+
+	FileCompressor() = default;
+	~FileCompressor();
+
+	FileCompressor(const FileCompressor&) = delete;
+	FileCompressor& operator=(const FileCompressor&) = delete;
+
+	/// <summary>
+	/// Start threads if they are not started yet
+	/// </summary>
+	void start(size_t threads_count, int level);
+
+	/// <summary>
+	/// Compress submitted files and stop threads
+	/// </summary>
+	void stop();
+
+	void submit(std::filesystem::path path, callback_t callback = {});
+
+	CompressionStats stats() const;
+
+	static std::filesystem::path compressed_path(const std::filesystem::path& path);
+
+private:
+	void worker_loop();
+	std::filesystem::path compress(const std::filesystem::path& path, int level);
+
+	struct Job
+	{
+		std::filesystem::path path;
+		callback_t callback;
+	};
+
+	mutable std::mutex mutex_;
+	std::condition_variable cv_;
+	std::deque<Job> queue_;
+	size_t active_ = 0;
+	int level_ = 0;
+	bool stop_ = false;
+	std::vector<std::thread> threads_;
+
+	std::atomic<uint64_t> compressed_ = 0;
+	std::atomic<uint64_t> failed_ = 0;
+	std::atomic<uint64_t> bytes_in_ = 0;
+	std::atomic<uint64_t> bytes_out_ = 0;
+};
+
+} // namespace logger
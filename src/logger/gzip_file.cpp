@@ -0,0 +1,137 @@
+#include "gzip_file.hpp"
+
+#include <miniz.h>
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+
+constexpr size_t READ_CHUNK_SIZE = 256 * 1024;
+constexpr size_t OUTPUT_CHUNK_SIZE = 64 * 1024;
+
+void put_uint32(uint32_t value, std::string& out)
+{
+	for (int i = 0; i < 4; ++i)
+		out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+} // namespace
+
+namespace logger
+{
+
+struct GzipEncoder::Deflate
+{
+	tdefl_compressor compressor;
+};
+
+GzipEncoder::GzipEncoder(int level)
+	: deflate_(std::make_unique<Deflate>())
+{
+	// raw deflate: the gzip header and trailer are written here
+	const int clamped = std::clamp(level, MIN_COMPRESSION_LEVEL, MAX_COMPRESSION_LEVEL);
+	tdefl_init(&deflate_->compressor, static_cast<int>(tdefl_create_comp_flags_from_zip_params(clamped, -MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY)));
+}
+
+GzipEncoder::~GzipEncoder() = default;
+
+void GzipEncoder::write(std::span<const char> data, std::string& out)
+{
+	if (!header_written_)
+	{
+		// magic, deflate, no flags, no modification time, no extra flags, unknown OS
+		out.append("\x1f\x8b\x08\x00\x00\x00\x00\x00\x00\xff", 10);
+		header_written_ = true;
+	}
+
+	// mz_crc32 restarts on the null pointer of empty data
+	if (!data.empty())
+		crc_ = static_cast<uint32_t>(mz_crc32(crc_, reinterpret_cast<const unsigned char*>(data.data()), data.size()));
+
+	input_size_ += data.size();
+
+	compress(data, false, out);
+}
+
+void GzipEncoder::finish(std::string& out)
+{
+	write({}, out);
+	compress({}, true, out);
+
+	put_uint32(crc_, out);
+	put_uint32(static_cast<uint32_t>(input_size_), out);
+}
+
+void GzipEncoder::compress(std::span<const char> data, bool final, std::string& out)
+{
+	const tdefl_flush flush = final ? TDEFL_FINISH : TDEFL_NO_FLUSH;
+
+	// the compressor keeps all the input it's given, the output is taken by chunks until it stops producing
+	for (;;)
+	{
+		const size_t offset = out.size();
+		out.resize(offset + OUTPUT_CHUNK_SIZE);
+
+		size_t in_size = data.size();
+		size_t out_size = OUTPUT_CHUNK_SIZE;
+		const tdefl_status status = tdefl_compress(&deflate_->compressor, data.data(), &in_size, out.data() + offset, &out_size, flush);
+		out.resize(offset + out_size);
+
+		if (status < TDEFL_STATUS_OKAY)
+			throw std::runtime_error(std::format("deflate failed with status {}", static_cast<int>(status)));
+
+		data = data.subspan(in_size);
+
+		if (status == TDEFL_STATUS_DONE || (data.empty() && !final && out_size < OUTPUT_CHUNK_SIZE))
+			return;
+	}
+}
+
+uint64_t gzip_file(const std::filesystem::path& from, const std::filesystem::path& to, int level)
+{
+	std::ifstream input(from, std::ios::binary);
+	if (!input)
+		throw std::runtime_error(std::format("can't open file \"{}\"", from.string()));
+
+	std::ofstream output(to, std::ios::binary | std::ios::trunc);
+	if (!output)
+		throw std::runtime_error(std::format("can't create file \"{}\"", to.string()));
+
+	GzipEncoder encoder(level);
+	std::vector<char> chunk(READ_CHUNK_SIZE);
+	std::string compressed;
+	uint64_t compressed_size = 0;
+
+	auto write_compressed = [&]()
+	{
+		output.write(compressed.data(), static_cast<std::streamsize>(compressed.size()));
+		compressed_size += compressed.size();
+		compressed.clear();
+	};
+
+	while (input)
+	{
+		input.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+		encoder.write(std::span<const char>(chunk.data(), static_cast<size_t>(input.gcount())), compressed);
+		write_compressed();
+	}
+
+	if (input.bad())
+		throw std::runtime_error(std::format("can't read file \"{}\"", from.string()));
+
+	encoder.finish(compressed);
+	write_compressed();
+
+	output.flush();
+	if (!output)
+		throw std::runtime_error(std::format("can't write file \"{}\"", to.string()));
+
+	return compressed_size;
+}
+
+} // namespace logger
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "logger_config.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+
+namespace logger
+{
+
+/// <summary>
+/// Streaming gzip (RFC 1952) encoder on top of the deflate compressor of miniz (src/thirdparty/miniz):
+/// LZ77 with lazy matching over the 32 KB window, dynamic Huffman codes and stored blocks for incompressible data.
+/// The level (1 - 9) is the zlib level: 1 - 3 are greedy and fast, 9 searches the longest matches.
+/// </summary>
+class GzipEncoder
+{
+public:
+	explicit GzipEncoder(int level);
+	~GzipEncoder();
+
+	GzipEncoder(const GzipEncoder&) = delete;
+	GzipEncoder& operator=(const GzipEncoder&) = delete;
+
+	/// <summary>
+	/// Compress the next part of the data and append the result to out
+	/// </summary>
+	void write(std::span<const char> data, std::string& out);
+
+	/// <summary>
+	/// Compress the rest of the data and append the final block and the gzip trailer to out
+	/// </summary>
+	void finish(std::string& out);
+
+	uint64_t input_size() const { return input_size_; }
+
+private:
+	void compress(std::span<const char> data, bool final, std::string& out);
+
+	struct Deflate;  // the compressor of miniz, about 300 KB, so it's allocated apart
+
+	std::unique_ptr<Deflate> deflate_;
+
+	uint32_t crc_ = 0;
+	uint64_t input_size_ = 0;
+	bool header_written_ = false;
+};
+
+/// <summary>
+/// Compress the file to the gzip file
+/// </summary>
+/// <returns>size of the compressed file</returns>
+/// <exception cref="std::runtime_error">the file can't be read or the result can't be written</exception>
+uint64_t gzip_file(const std::filesystem::path& from, const std::filesystem::path& to, int level);
+
+} // namespace logger
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "packed_args.hpp"
+
+#include <array>
+#include <cstddef>
+#include <format>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace logger
+{
+
+constexpr size_t SMALL_MESSAGE_SIZE = 256;
+
+/// <summary>
+/// Per-thread buffers for log entries assembling. Buffers keep their capacity between calls,
+/// so after warming up logging doesn't allocate memory.
+/// </summary>
+struct ThreadLogBuffers
+{
+	std::array<char, SMALL_MESSAGE_SIZE> small_message;
+	std::string message;
+	std::string entry;
+	ArgsBuffer args;
+};
+
+inline ThreadLogBuffers& this_thread_log_buffers()
+{
+	thread_local ThreadLogBuffers buffers;
+	return buffers;
+}
+
+/// <summary>
+/// Output iterator of format_message: characters go to the fixed size array of the buffers until it is full,
+/// then the array is copied to the growable string and the rest is appended there. The state is kept
+/// outside, so copies of the iterator made by std::format write to the same message.
+/// </summary>
+class MessageOutputIterator
+{
+public:
+	using difference_type = std::ptrdiff_t;
+
+	struct State
+	{
+		ThreadLogBuffers& buffers;
+		size_t size = 0;
+	};
+
+	explicit MessageOutputIterator(State& state)
+		: state_(&state)
+	{
+	}
+
+	MessageOutputIterator& operator*() { return *this; }
+	MessageOutputIterator& operator++() { return *this; }
+	MessageOutputIterator operator++(int) { return *this; }
+
+	MessageOutputIterator& operator=(const char c)
+	{
+		auto& small_message = state_->buffers.small_message;
+
+		if (state_->size < small_message.size())
+		{
+			small_message[state_->size++] = c;
+			return *this;
+		}
+
+		if (state_->size == small_message.size())
+			state_->buffers.message.assign(small_message.data(), small_message.size());
+
+		state_->buffers.message.push_back(c);
+		++state_->size;
+		return *this;
+	}
+
+private:
+	State* state_;
+};
+
+/// <summary>
+/// Format message to the thread buffers in one pass. Messages up to SMALL_MESSAGE_SIZE stay in the
+/// fixed size array; longer messages continue in the growable string.
+/// </summary>
+/// <returns>view that is valid until the next call on the same thread</returns>
+template<class... Args>
+inline std::string_view format_message(ThreadLogBuffers& buffers, std::format_string<Args...> format, Args&&... args)
+{
+	MessageOutputIterator::State state{ buffers };
+	std::format_to(MessageOutputIterator(state), format, std::forward<Args>(args)...);
+
+	if (state.size <= buffers.small_message.size())
+		return { buffers.small_message.data(), state.size };
+
+	return buffers.message;
+}
+
+} // namespace logger
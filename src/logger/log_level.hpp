@@ -16,6 +16,60 @@ enum class Level : uint16_t
 
 constexpr Level DEFAULT_LOG_LEVEL = Level::DEBUG;
 
+// Define LOGGER_STATIC_MIN_LEVEL as one of Level enumerators (for example, INFO) to remove
+// all messages of lower levels at compile time for loggers without StaticMinLevel option
+#ifndef LOGGER_STATIC_MIN_LEVEL
+	#define LOGGER_STATIC_MIN_LEVEL DEBUG
+#endif
+
+constexpr Level DEFAULT_STATIC_MIN_LEVEL = Level::LOGGER_STATIC_MIN_LEVEL;
+
+/// <summary>
+/// Logger option that sets minimal level at compile time. Calls of lower levels are compiled to nothing:
+/// Logger<StaticMinLevel<Level::INFO>, DefaultConsoleLoggerPolicy>
+/// </summary>
+template<Level MinLevel>
+struct StaticMinLevel
+{
+	using logger_option_tag = void;
+
+	static constexpr Level level = MinLevel;
+};
+
+namespace internal
+{
+
+template<class T>
+constexpr bool is_static_min_level_v = false;
+
+template<Level MinLevel>
+constexpr bool is_static_min_level_v<StaticMinLevel<MinLevel>> = true;
+
+template<class... Ts>
+struct find_static_min_level
+{
+	static constexpr Level value = DEFAULT_STATIC_MIN_LEVEL;
+};
+
+template<class T, class... Ts>
+struct find_static_min_level<T, Ts...>
+{
+	static constexpr Level value = [] {
+		if constexpr (is_static_min_level_v<T>)
+			return T::level;
+		else
+			return find_static_min_level<Ts...>::value;
+	}();
+};
+
+} // namespace internal
+
+/// <summary>
+/// Level of the first StaticMinLevel in the list or DEFAULT_STATIC_MIN_LEVEL if there is no one
+/// </summary>
+template<class... Ts>
+constexpr Level static_min_level_v = internal::find_static_min_level<Ts...>::value;
+
 /// <summary>
 /// Converting string representation of level to logger::Level enum value
 /// </summary>
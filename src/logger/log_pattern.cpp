@@ -0,0 +1,43 @@
+#include "log_pattern.hpp"
+
+#include <stdexcept>
+
+namespace logger
+{
+
+CompiledLogPattern::CompiledLogPattern(std::string_view pattern)
+{
+	if (!compile_log_pattern(pattern, text_, tokens_))
+		throw std::invalid_argument("invalid log pattern");
+
+	for (const PatternToken& token : tokens_)
+	{
+		if (token.is_field)
+			++fields_count_[static_cast<size_t>(token.field)];
+	}
+}
+
+size_t CompiledLogPattern::formatted_size(const pattern_fields_t& fields) const
+{
+	size_t result = text_.size();
+
+	for (size_t i = 0; i < PATTERN_FIELDS_COUNT; ++i)
+		result += fields_count_[i] * fields[i].size();
+
+	return result;
+}
+
+void CompiledLogPattern::format_to(std::string& out, const pattern_fields_t& fields) const
+{
+	out.reserve(out.size() + formatted_size(fields));
+
+	for (const PatternToken& token : tokens_)
+	{
+		if (token.is_field)
+			out.append(fields[static_cast<size_t>(token.field)]);
+		else
+			out.append(text_, token.offset, token.size);
+	}
+}
+
+} // namespace logger
@@ -0,0 +1,280 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace logger
+{
+
+/// <summary>
+/// Log pattern fields. Values are the same as std::format argument indices
+/// that replace_log_pattern_placeholders assigns to placeholders.
+/// </summary>
+enum class PatternField : uint8_t
+{
+	TIME,
+	THREAD_ID,
+	LEVEL,
+	MESSAGE
+};
+
+constexpr size_t PATTERN_FIELDS_COUNT = 4;
+
+/// <summary>
+/// Values of pattern fields indexed by PatternField
+/// </summary>
+using pattern_fields_t = std::array<std::string_view, PATTERN_FIELDS_COUNT>;
+
+struct PatternToken
+{
+	bool is_field = false;
+	PatternField field = PatternField::TIME;
+	size_t offset = 0; // literal offset in the compiled pattern text
+	size_t size = 0;   // literal size
+};
+
+/// <summary>
+/// Replace pattern placeholders ({{time}}, {{thread-id}}, {{level}}, {{message}})
+/// with std::format argument indices ({0}, {1}, {2}, {3})
+/// </summary>
+constexpr void replace_log_pattern_placeholders(std::string& pattern)
+{
+	using value_t = std::pair<std::string_view, std::string_view>;
+
+	constexpr std::array<value_t, PATTERN_FIELDS_COUNT> variables = { {
+		{ "{{time}}",      "{0}" },
+		{ "{{thread-id}}", "{1}" },
+		{ "{{level}}",     "{2}" } ,
+		{ "{{message}}",   "{3}" }
+	} };
+
+	std::ranges::for_each(variables, [&pattern](const value_t& item) mutable
+	{
+		size_t index = 0;
+		while ((index = pattern.find(item.first, index)) != std::string::npos)
+		{
+			pattern.replace(index, item.first.size(), item.second);
+			index += item.second.size();
+		}
+	});
+}
+
+/// <summary>
+/// Compile log pattern to the sequence of literal and field tokens.
+/// Placeholders are replaced first, then the result is parsed with std::format rules:
+/// "{{" and "}}" are escaped braces and "{0}".."{3}" are fields. Other replacement fields are not supported.
+/// </summary>
+/// <param name="pattern">log pattern with placeholders</param>
+/// <param name="text">output text where all literals are stored</param>
+/// <param name="tokens">output tokens; adjacent literals are merged</param>
+/// <returns>false if pattern is invalid</returns>
+constexpr bool compile_log_pattern(std::string_view pattern, std::string& text, std::vector<PatternToken>& tokens)
+{
+	std::string format (pattern);
+	replace_log_pattern_placeholders(format);
+
+	text.clear();
+	tokens.clear();
+
+	auto add_char = [&text, &tokens](char c)
+	{
+		if (tokens.empty() || tokens.back().is_field)
+			tokens.push_back(PatternToken { false, PatternField::TIME, text.size(), 0 });
+
+		text.push_back(c);
+		++tokens.back().size;
+	};
+
+	for (size_t i = 0; i < format.size(); ++i)
+	{
+		const char c = format[i];
+		const bool escaped = (c == '{' || c == '}') && i + 1 < format.size() && format[i + 1] == c;
+
+		if (c == '{' && !escaped)
+		{
+			if (i + 2 >= format.size() || format[i + 1] < '0' || format[i + 1] > '3' || format[i + 2] != '}')
+				return false;
+
+			tokens.push_back(PatternToken { true, static_cast<PatternField>(format[i + 1] - '0'), 0, 0 });
+			i += 2;
+		}
+		else if (c == '}' && !escaped)
+		{
+			return false;
+		}
+		else
+		{
+			add_char(c);
+
+			if (escaped)
+				++i;
+		}
+	}
+
+	return true;
+}
+
+/// <summary>
+/// Log pattern compiled at runtime (for example, from the configuration file)
+/// into the sequence of literal and field tokens.
+/// </summary>
+class CompiledLogPattern
+{
+public:
+	CompiledLogPattern() = default;
+
+	/// <exception cref="std::invalid_argument">pattern is invalid</exception>
+	explicit CompiledLogPattern(std::string_view pattern);
+
+	/// <summary>
+	/// Append log entry to the output string. Output is reserved for exact log entry size.
+	/// </summary>
+	void format_to(std::string& out, const pattern_fields_t& fields) const;
+
+	/// <summary>
+	/// Exact log entry size for the specified fields values
+	/// </summary>
+	size_t formatted_size(const pattern_fields_t& fields) const;
+
+private:
+	std::string text_;
+	std::vector<PatternToken> tokens_;
+	std::array<size_t, PATTERN_FIELDS_COUNT> fields_count_ {};
+};
+
+template<size_t N>
+struct FixedString
+{
+	constexpr FixedString(const char (&str)[N])
+	{
+		std::copy_n(str, N, data);
+	}
+
+	constexpr std::string_view view() const { return { data, N - 1 }; }
+
+	char data[N] {};
+};
+
+/// <summary>
+/// Log pattern compiled at compile time. Pass it to the Logger among policies
+/// to override log_pattern from LoggerConfig:
+/// Logger<StaticLogPattern<"[{{time}}] {{message}}">, DefaultConsoleLoggerPolicy>
+/// Log entry formatting is a straight-line sequence of appends without any pattern parsing.
+/// </summary>
+template<FixedString Pattern>
+class StaticLogPattern
+{
+public:
+	using logger_option_tag = void;
+
+private:
+	static constexpr size_t CAPACITY = Pattern.view().size() + 1;
+
+	struct Compiled
+	{
+		bool valid = false;
+		std::array<char, CAPACITY> text {};
+		std::array<PatternToken, CAPACITY> tokens {};
+		size_t tokens_count = 0;
+	};
+
+	static consteval Compiled compile()
+	{
+		std::string text;
+		std::vector<PatternToken> tokens;
+
+		Compiled result;
+		result.valid = compile_log_pattern(Pattern.view(), text, tokens);
+		std::ranges::copy(text, result.text.begin());
+		std::ranges::copy(tokens, result.tokens.begin());
+		result.tokens_count = tokens.size();
+
+		return result;
+	}
+
+	static constexpr Compiled compiled_ = compile();
+	static_assert(compiled_.valid, "invalid log pattern");
+
+	static constexpr std::array<char, CAPACITY> text_ = compiled_.text;
+
+public:
+	static constexpr std::string_view pattern = Pattern.view();
+
+	/// <summary>
+	/// Append log entry to the output string
+	/// </summary>
+	static inline void format_to(std::string& out, const pattern_fields_t& fields)
+	{
+		format_to(out, fields, std::make_index_sequence<compiled_.tokens_count>());
+	}
+
+private:
+	template<size_t... I>
+	static inline void format_to(std::string& out, const pattern_fields_t& fields, std::index_sequence<I...>)
+	{
+		out.reserve(out.size() + (size_t(0) + ... + token_size<I>(fields)));
+		(append_token<I>(out, fields), ...);
+	}
+
+	template<size_t I>
+	static inline size_t token_size(const pattern_fields_t& fields)
+	{
+		constexpr PatternToken token = compiled_.tokens[I];
+
+		if constexpr (token.is_field)
+			return fields[static_cast<size_t>(token.field)].size();
+		else
+			return token.size;
+	}
+
+	template<size_t I>
+	static inline void append_token(std::string& out, const pattern_fields_t& fields)
+	{
+		constexpr PatternToken token = compiled_.tokens[I];
+
+		if constexpr (token.is_field)
+			out.append(fields[static_cast<size_t>(token.field)]);
+		else
+			out.append(text_.data() + token.offset, token.size);
+	}
+};
+
+namespace internal
+{
+
+template<class T>
+constexpr bool is_static_log_pattern_v = false;
+
+template<FixedString Pattern>
+constexpr bool is_static_log_pattern_v<StaticLogPattern<Pattern>> = true;
+
+template<class... Ts>
+struct find_static_log_pattern
+{
+	using type = void;
+};
+
+template<class T, class... Ts>
+struct find_static_log_pattern<T, Ts...>
+{
+	using type = std::conditional_t<is_static_log_pattern_v<T>, T, typename find_static_log_pattern<Ts...>::type>;
+};
+
+} // namespace internal
+
+template<class T>
+concept static_log_pattern = internal::is_static_log_pattern_v<T>;
+
+/// <summary>
+/// The first StaticLogPattern in the list or void if there is no one
+/// </summary>
+template<class... Ts>
+using static_log_pattern_t = typename internal::find_static_log_pattern<Ts...>::type;
+
+} // namespace logger
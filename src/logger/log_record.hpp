@@ -0,0 +1,58 @@
+#pragma once
+
+#include "log_level.hpp"
+#include "providers/time_provider.hpp"
+
+#include <concepts>
+#include <cstddef>
+#include <format>
+#include <source_location>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+namespace logger
+{
+
+/// <summary>
+/// Log entry before formatting by the log pattern. Views are valid only during the policy call.
+/// </summary>
+struct LogRecord
+{
+	TimeProvider::time_point time;
+	std::string_view thread_id;
+	Level level = Level::DEBUG;
+	std::string_view message;
+	std::source_location location;
+
+	// format string with static storage duration and arguments packed by pack_args, if the message
+	// was logged with packable arguments and some policy reads them (see packed_record_policy)
+	std::string_view format;
+	std::span<const std::byte> args;
+};
+
+/// <summary>
+/// Format string that captures the source location of the logging call
+/// </summary>
+template<class... Args>
+struct LocatedFormatString
+{
+	template<class T>
+		requires std::convertible_to<const T&, std::string_view>
+	consteval LocatedFormatString(const T& format, std::source_location location = std::source_location::current())
+		: format(format)
+		, location(location)
+	{
+	}
+
+	std::format_string<Args...> format;
+	std::source_location location;
+};
+
+/// <summary>
+/// Format string parameter type of logging functions: like std::format_string, arguments are not deduced from it
+/// </summary>
+template<class... Args>
+using located_format_string = std::type_identity_t<LocatedFormatString<Args...>>;
+
+} // namespace logger
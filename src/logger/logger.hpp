@@ -1,122 +1,125 @@
 ﻿#pragma once
 
-#include "logger_concepts.hpp"
-#include "log_level.hpp"
-#include "logger_config.hpp"
-#include "utils.hpp"
-#include "providers/dependency_container.hpp"
-#include "providers/time_provider.hpp"
-
-#include <array>
+#include "logger_base.hpp"
+#include "log_buffers.hpp"
+#include "log_record.hpp"
+#include "packed_args.hpp"
+
 #include <string>
-#include <strstream>
 #include <string_view>
-#include <time.h>
-#include <mutex>
 #include <chrono>
-#include <thread>
+#include <format>
+#include <source_location>
 
 namespace chrono = std::chrono;
 
 namespace logger
 {
 
-template<logger_policy... Policies>
-class Logger
+template<logger_component... Policies>
+class Logger : public LoggerBase<Policies...>
 {
+	using base_t = LoggerBase<Policies...>;
+
 public:
 	using Level = Level;
 
 	explicit Logger(LoggerConfig config = LoggerConfig())
-		: config_(std::move(config))
-	{
-		(init_if_needed<Policies>(), ...);
-
-		setup_config();
-	}
-
-	~Logger()
+		: base_t(std::move(config))
 	{
-		(release_if_needed<Policies>(), ...);
 	}
 
-	Logger(Logger&&) = delete;
-	Logger& operator=(Logger&&) = delete;
-	Logger(const Logger&) = delete;
-	Logger& operator=(const Logger&) = delete;
-
-	void log(Level level, const std::string_view message) const;
-
-	inline void debug(const std::string_view message)   const { log(Level::DEBUG, message); }
-	inline void info(const std::string_view message)    const { log(Level::INFO, message); }
-	inline void warning(const std::string_view message) const { log(Level::WARNING, message); }
-	inline void error(const std::string_view message)   const { log(Level::ERROR, message); }
-
-	const LoggerConfig& get_config() const { return config_; }
+	void log(Level level, const std::string_view message, std::source_location location = std::source_location::current()) const;
+
+	/// <summary>
+	/// Log message formatted with std::format rules. Message is formatted only if the level is not filtered.
+	/// Packed record policies get the format string and packed arguments; if there is no other policy,
+	/// the message isn't formatted at all.
+	/// </summary>
+	template<class... Args>
+	void log(Level level, located_format_string<Args...> format, Args&&... args) const;
+
+	inline void debug(const std::string_view message, std::source_location location = std::source_location::current())   const { if constexpr (base_t::is_enabled(Level::DEBUG)) log(Level::DEBUG, message, location); }
+	inline void info(const std::string_view message, std::source_location location = std::source_location::current())    const { if constexpr (base_t::is_enabled(Level::INFO)) log(Level::INFO, message, location); }
+	inline void warning(const std::string_view message, std::source_location location = std::source_location::current()) const { if constexpr (base_t::is_enabled(Level::WARNING)) log(Level::WARNING, message, location); }
+	inline void error(const std::string_view message, std::source_location location = std::source_location::current())   const { if constexpr (base_t::is_enabled(Level::ERROR)) log(Level::ERROR, message, location); }
+
+	template<class... Args>
+	inline void debug(located_format_string<Args...> format, Args&&... args) const { if constexpr (base_t::is_enabled(Level::DEBUG)) log(Level::DEBUG, format, std::forward<Args>(args)...); }
+	template<class... Args>
+	inline void info(located_format_string<Args...> format, Args&&... args) const { if constexpr (base_t::is_enabled(Level::INFO)) log(Level::INFO, format, std::forward<Args>(args)...); }
+	template<class... Args>
+	inline void warning(located_format_string<Args...> format, Args&&... args) const { if constexpr (base_t::is_enabled(Level::WARNING)) log(Level::WARNING, format, std::forward<Args>(args)...); }
+	template<class... Args>
+	inline void error(located_format_string<Args...> format, Args&&... args) const { if constexpr (base_t::is_enabled(Level::ERROR)) log(Level::ERROR, format, std::forward<Args>(args)...); }
 
 private:
-	inline std::string get_this_thread_id() const;
-
-	template<class Policy>
-	inline void init_if_needed() const
-	{
-		if constexpr (initialized_policy<Policy>)
-			Policy::init();
-	}
-
-	template<class Policy>
-	inline void release_if_needed() const
-	{
-		if constexpr (releasable_policy<Policy>)
-			Policy::release();
-	}
+	void write_entry(Level level,
+					 const std::string_view message,
+					 const std::source_location& location,
+					 const std::string_view format = {},
+					 const std::span<const std::byte> args = {}) const;
 
-	void setup_config();
+}; // class Logger
 
-	mutable std::mutex log_mutex_ = std::mutex();
-	const LoggerConfig config_;
-	std::string message_format_;
+template<logger_component ...Policies>
+inline void Logger<Policies...>::log(Level level, const std::string_view message, std::source_location location) const
+{
+	if (this->is_filtered(level))
+		return;
 
-}; // class Logger
+	write_entry(level, message, location);
+}
 
-template<logger_policy ...Policies>
-inline void Logger<Policies...>::log(Level level, const std::string_view message) const
+template<logger_component ...Policies>
+template<class ...Args>
+inline void Logger<Policies...>::log(Level level, located_format_string<Args...> format, Args&&... args) const
 {
-	if (level < config_.log_level)
+	if (this->is_filtered(level))
 		return;
 
-	std::scoped_lock lock(log_mutex_);
+	ThreadLogBuffers& buffers = this_thread_log_buffers();
 
-	std::string now_str = DependencyContainer::get<TimeProvider>()->now();
+	if constexpr (base_t::packs_args && (packable_arg<Args> && ...))
+	{
+		pack_args(buffers.args, args...);
 
-	const std::string log_entry = std::vformat(message_format_, std::make_format_args(now_str,
-															   get_this_thread_id(),
-															   level_to_str(level),
-															   message));
+		std::string_view message;
+		if constexpr (base_t::formats_messages)
+			message = format_message(buffers, format.format, std::forward<Args>(args)...);
 
-	(Policies::write(log_entry), ...);
+		write_entry(level, message, format.location, format.format.get(), { buffers.args.data(), buffers.args.size() });
+	}
+	else
+	{
+		write_entry(level, format_message(buffers, format.format, std::forward<Args>(args)...), format.location);
+	}
 }
 
-template<logger_policy ...Policies>
-inline std::string Logger<Policies...>::get_this_thread_id() const
+template<logger_component ...Policies>
+inline void Logger<Policies...>::write_entry(Level level,
+											 const std::string_view message,
+											 const std::source_location& location,
+											 const std::string_view format,
+											 const std::span<const std::byte> args) const
 {
-	std::stringstream ss;
-	ss << std::this_thread::get_id();
+	const TimeProvider& time_provider = *DependencyContainer::get_cached<TimeProvider>();
 
-	return ss.str();
-}
+	const LogRecord record { time_provider.timestamp(), this_thread_id(this->get_config().thread_id_type), level, message, location, format, args };
 
-extern void replace_log_pattern_placeholders(std::string& pattern);
+	if constexpr (base_t::formats_text)
+	{
+		std::string& log_entry = this_thread_log_buffers().entry;
 
-template<logger_policy ...Policies>
-inline void Logger<Policies...>::setup_config()
-{
-	const auto [ result, message ] = validate_config(config_);
-	if (!result)
-		throw std::invalid_argument(message);
+		log_entry.clear();
+		this->format_entry(log_entry, record, time_provider);
 
-	message_format_ = copy(config_.log_pattern);
-	replace_log_pattern_placeholders(message_format_);
+		this->write_to_policies(record, log_entry);
+	}
+	else
+	{
+		this->write_to_policies(record, {});
+	}
 }
 
 template<class T, class P>
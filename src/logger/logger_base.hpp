@@ -0,0 +1,272 @@
+#pragma once
+
+#include "logger_concepts.hpp"
+#include "log_level.hpp"
+#include "logger_config.hpp"
+#include "log_pattern.hpp"
+#include "log_record.hpp"
+#include "thread_info.hpp"
+#include "utils.hpp"
+#include "providers/dependency_container.hpp"
+#include "providers/time_provider.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <stdexcept>
+
+namespace logger
+{
+
+namespace internal
+{
+
+/// <summary>
+/// Mutex that serializes calls of the policy which is not concurrent_policy.
+/// It is shared by all loggers, because policies are static.
+/// </summary>
+template<class Policy>
+inline std::mutex policy_mutex;
+
+} // namespace internal
+
+/// <summary>
+/// Common part of synchronous and asynchronous loggers: policies lifecycle,
+/// configuration and log entry formatting.
+/// </summary>
+template<logger_component... Policies>
+class LoggerBase
+{
+	using static_pattern_t = static_log_pattern_t<Policies...>;
+
+public:
+	using Level = Level;
+
+	static constexpr Level min_level = static_min_level_v<Policies...>;
+
+	/// <summary>
+	/// Check if messages of the level are compiled in (see StaticMinLevel)
+	/// </summary>
+	static constexpr bool is_enabled(Level level) { return level >= min_level; }
+
+	/// <summary>
+	/// Some policy receives formatted text. If all policies are record ones, log entries are not formatted at all.
+	/// </summary>
+	static constexpr bool formats_text = (text_policy<Policies> || ...);
+
+	/// <summary>
+	/// Some policy needs formatted messages: if all policies are packed record ones, only arguments are packed
+	/// </summary>
+	static constexpr bool formats_messages = ((output_policy<Policies> && !packed_record_policy<Policies>) || ...);
+
+	/// <summary>
+	/// Some policy reads format strings and packed arguments of records
+	/// </summary>
+	static constexpr bool packs_args = (packed_record_policy<Policies> || ...);
+
+	explicit LoggerBase(LoggerConfig config)
+		: config_(std::move(config))
+		, level_(config_.log_level)
+	{
+		(init_if_needed<Policies>(), ...);
+
+		setup_config();
+
+		(configure_if_needed<Policies>(), ...);
+	}
+
+	~LoggerBase()
+	{
+		(release_if_needed<Policies>(), ...);
+	}
+
+	LoggerBase(LoggerBase&&) = delete;
+	LoggerBase& operator=(LoggerBase&&) = delete;
+	LoggerBase(const LoggerBase&) = delete;
+	LoggerBase& operator=(const LoggerBase&) = delete;
+
+	const LoggerConfig& get_config() const { return config_; }
+
+	/// <summary>
+	/// Change minimal level at runtime. Could be called from any thread, doesn't block logging.
+	/// Initial value is log_level from the configuration.
+	/// </summary>
+	void set_level(Level level) { level_.store(level, std::memory_order_relaxed); }
+	Level get_level() const { return level_.load(std::memory_order_relaxed); }
+
+protected:
+	inline bool is_filtered(Level level) const { return !is_enabled(level) || level < get_level(); }
+
+	/// <summary>
+	/// Append log entry formatted by the log pattern to the output string
+	/// </summary>
+	void format_entry(std::string& out, const LogRecord& record, const TimeProvider& time_provider) const;
+
+	/// <summary>
+	/// Write log entry to policies: record policies get the record, text policies get the formatted entry.
+	/// Could be called from several threads: only calls of the same not concurrent policy are serialized.
+	/// </summary>
+	inline void write_to_policies(const LogRecord& record, const std::string_view log_entry) const
+	{
+		(write_to_policy<Policies>(record, log_entry), ...);
+	}
+
+	/// <summary>
+	/// Write log entries to policies: batch policies get all entries in one call, others get them one by one
+	/// </summary>
+	inline void write_batch_to_policies(const std::span<const LogRecord> records,
+										const std::span<const std::string_view> log_entries) const
+	{
+		(write_batch_to_policy<Policies>(records, log_entries), ...);
+	}
+
+	/// <summary>
+	/// Write log entry to the single policy (does nothing for logger options)
+	/// </summary>
+	template<class Policy>
+	inline void write_to_policy(const LogRecord& record, const std::string_view log_entry) const
+	{
+		if constexpr (output_policy<Policy> && !concurrent_policy<Policy>)
+		{
+			std::scoped_lock lock(internal::policy_mutex<Policy>);
+			write_unlocked<Policy>(record, log_entry);
+		}
+		else
+		{
+			write_unlocked<Policy>(record, log_entry);
+		}
+	}
+
+	template<class Policy>
+	inline void write_batch_to_policy(const std::span<const LogRecord> records,
+									  const std::span<const std::string_view> log_entries) const
+	{
+		if constexpr (output_policy<Policy> && !concurrent_policy<Policy>)
+		{
+			std::scoped_lock lock(internal::policy_mutex<Policy>);
+			write_batch_unlocked<Policy>(records, log_entries);
+		}
+		else
+		{
+			write_batch_unlocked<Policy>(records, log_entries);
+		}
+	}
+
+private:
+	void format_entry(std::string& out,
+					  const std::string_view time,
+					  const std::string_view thread_id,
+					  Level level,
+					  const std::string_view message) const;
+
+	template<class Policy>
+	inline void write_unlocked(const LogRecord& record, const std::string_view log_entry) const
+	{
+		if constexpr (record_policy<Policy>)
+			Policy::write(record);
+		else if constexpr (logger_policy<Policy>)
+			Policy::write(log_entry);
+
+		if constexpr (flushable_policy<Policy>)
+		{
+			if (record.level >= config_.flush_level)
+				Policy::flush();
+		}
+	}
+
+	template<class Policy>
+	inline void write_batch_unlocked(const std::span<const LogRecord> records,
+									 const std::span<const std::string_view> log_entries) const
+	{
+		if constexpr (record_policy<Policy>)
+		{
+			for (const LogRecord& record : records)
+				Policy::write(record);
+		}
+		else if constexpr (batch_policy<Policy>)
+		{
+			Policy::write_batch(log_entries);
+		}
+		else if constexpr (logger_policy<Policy>)
+		{
+			for (const std::string_view log_entry : log_entries)
+				Policy::write(log_entry);
+		}
+
+		if constexpr (flushable_policy<Policy>)
+		{
+			const Level flush_level = config_.flush_level;
+			if (std::ranges::any_of(records, [flush_level](const LogRecord& record) { return record.level >= flush_level; }))
+				Policy::flush();
+		}
+	}
+
+	template<class Policy>
+	inline void init_if_needed() const
+	{
+		if constexpr (initialized_policy<Policy>)
+			Policy::init();
+	}
+
+	template<class Policy>
+	inline void configure_if_needed() const
+	{
+		if constexpr (configurable_policy<Policy>)
+			Policy::configure(config_);
+	}
+
+	template<class Policy>
+	inline void release_if_needed() const
+	{
+		if constexpr (releasable_policy<Policy>)
+			Policy::release();
+	}
+
+	void setup_config();
+
+	const LoggerConfig config_;
+	std::atomic<Level> level_;
+	CompiledLogPattern pattern_;
+
+}; // class LoggerBase
+
+template<logger_component ...Policies>
+inline void LoggerBase<Policies...>::format_entry(std::string& out, const LogRecord& record, const TimeProvider& time_provider) const
+{
+	char time_buffer[TIME_BUFFER_SIZE];
+	const size_t time_size = time_provider.format_to(record.time, time_buffer, TIME_BUFFER_SIZE);
+
+	format_entry(out, { time_buffer, time_size }, record.thread_id, record.level, record.message);
+}
+
+template<logger_component ...Policies>
+inline void LoggerBase<Policies...>::format_entry(std::string& out,
+												  const std::string_view time,
+												  const std::string_view thread_id,
+												  Level level,
+												  const std::string_view message) const
+{
+	const std::string_view level_str = level_to_str(level);
+	const pattern_fields_t fields = { time, thread_id, level_str, message };
+
+	if constexpr (static_log_pattern<static_pattern_t>)
+		static_pattern_t::format_to(out, fields);
+	else
+		pattern_.format_to(out, fields);
+}
+
+template<logger_component ...Policies>
+inline void LoggerBase<Policies...>::setup_config()
+{
+	const auto [ result, message ] = validate_config(config_);
+	if (!result)
+		throw std::invalid_argument(message);
+
+	if constexpr (!static_log_pattern<static_pattern_t>)
+		pattern_ = CompiledLogPattern(config_.log_pattern);
+}
+
+} // namespace logger
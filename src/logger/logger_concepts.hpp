@@ -1,6 +1,11 @@
 #pragma once
 
+#include "log_record.hpp"
+#include "logger_config.hpp"
+
 #include <type_traits>
+#include <concepts>
+#include <span>
 #include <string_view>
 
 namespace logger
@@ -12,18 +17,103 @@ concept logger_policy = requires (const std::string_view message)
 	{ T::write(message) };
 };
 
+/// <summary>
+/// Policy that receives log records instead of formatted text (for example, binary or structured output).
+/// If a policy satisfies both logger_policy and record_policy, it gets records only.
+/// </summary>
+template<class T>
+concept record_policy = requires (const LogRecord& record)
+{
+	{ T::write(record) };
+};
+
+/// <summary>
+/// Record policy that reads the format string and packed arguments of records (LogRecord::format and args)
+/// instead of the formatted message. If all policies of the logger are such ones, messages are not formatted:
+/// LogRecord::message is set only for messages logged without format arguments.
+/// </summary>
+template<class T>
+concept packed_record_policy = record_policy<T> && requires
+{
+	typename T::packed_record_policy_tag;
+};
+
+/// <summary>
+/// Policy that receives log entries formatted by the log pattern
+/// </summary>
+template<class T>
+concept text_policy = logger_policy<T> && !record_policy<T>;
+
+/// <summary>
+/// Policy that logger writes to: text or record one
+/// </summary>
+template<class T>
+concept output_policy = logger_policy<T> || record_policy<T>;
+
+/// <summary>
+/// Policy that could be called from several threads at the same time (it synchronizes itself or doesn't need it).
+/// Calls of other policies are serialized by loggers.
+/// </summary>
+template<class T>
+concept concurrent_policy = output_policy<T> && requires
+{
+	typename T::concurrent_policy_tag;
+};
+
+/// <summary>
+/// Policy that could write several log entries at once (for example, with one system call).
+/// Loggers pass batches to write_batch when they have more than one entry to write;
+/// other policies get entries one by one through write.
+/// </summary>
+template<class T>
+concept batch_policy = text_policy<T> && requires (const std::span<const std::string_view> messages)
+{
+	{ T::write_batch(messages) };
+};
+
+/// <summary>
+/// Policy that gets the logger configuration: loggers call configure() on construction after init()
+/// </summary>
+template<class T>
+concept configurable_policy = output_policy<T> && requires (const LoggerConfig& config)
+{
+	{ T::configure(config) };
+};
+
+/// <summary>
+/// Policy that buffers output: loggers call flush() after entries of flush_level and higher from the configuration
+/// </summary>
 template<class T>
-concept initialized_policy = logger_policy<T> && requires
+concept flushable_policy = output_policy<T> && requires
+{
+	{ T::flush() };
+};
+
+template<class T>
+concept initialized_policy = output_policy<T> && requires
 {
 	{ T::init() };
 };
 
 template<class T>
-concept releasable_policy = logger_policy<T> && requires
+concept releasable_policy = output_policy<T> && requires
 {
 	{ T::release() };
 };
 
+/// <summary>
+/// Logger options are passed to the logger among policies, but they are not written to:
+/// they change logger behavior at compile time (see StaticLogPattern)
+/// </summary>
+template<class T>
+concept logger_option = requires
+{
+	typename T::logger_option_tag;
+};
+
+template<class T>
+concept logger_component = output_policy<T> || logger_option<T>;
+
 template<class Policy, class... Policies>
 concept is_polisy_in_list = (std::same_as<Policy, Policies> || ...);
 
@@ -41,8 +131,18 @@ concept has_levels = requires
 	{ T::Level::ERROR };
 };
 
+/// <summary>
+/// T has minimal level known at compile time: calls of lower levels are compiled to nothing
+/// </summary>
 template<class T>
-concept is_logger = has_levels<T> && requires (const T logger, const T const_logger, typename T::Level level, const std::string_view message)
+concept has_min_level = has_levels<T> && requires
+{
+	{ T::min_level } -> std::convertible_to<typename T::Level>;
+	{ std::bool_constant<T::is_enabled(T::Level::DEBUG)>() };
+};
+
+template<class T>
+concept is_logger = has_min_level<T> && requires (const T logger, const T const_logger, typename T::Level level, const std::string_view message)
 {
 	{ const_logger.log(level, message) };
 	{ const_logger.debug(message) };
@@ -54,4 +154,7 @@ concept is_logger = has_levels<T> && requires (const T logger, const T const_log
 template<class T>
 concept logger_type = is_logger<T>;
 
+template<has_min_level T>
+constexpr typename T::Level logger_min_level_v = T::min_level;
+
 } // namespace logger
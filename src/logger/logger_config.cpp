@@ -1,5 +1,6 @@
 #include "logger_config.hpp"
 #include "log_level.hpp"
+#include "log_pattern.hpp"
 #include "utils.hpp"
 
 #include <rapidjson/document.h>
@@ -8,50 +9,15 @@
 #include <iostream>
 #include <functional>
 #include <array>
+#include <vector>
 #include <format>
+#include <algorithm>
 
 namespace fs = std::filesystem;
 
 namespace
 {
 
-inline void replace_placeholder(std::string& pattern, std::string_view placeholder, std::string_view value)
-{
-	size_t index = 0;
-	while ((index = pattern.find(placeholder, index)) != std::string::npos)
-	{
-		pattern.replace(index, placeholder.size(), value);
-		index += value.size();
-	}
-}
-
-}
-
-namespace logger
-{
-
-void replace_log_pattern_placeholders(std::string& pattern)
-{
-	using value_t = std::pair<std::string_view, std::string_view>;
-
-	static constexpr std::array<value_t, 4> variables = { {
-		{ "{{time}}",      "{0}" },
-		{ "{{thread-id}}", "{1}" },
-		{ "{{level}}",     "{2}" } ,
-		{ "{{message}}",   "{3}" }
-	} };
-
-	std::ranges::for_each(variables, [&pattern](const value_t& item) mutable
-	{
-		replace_placeholder(pattern, item.first, item.second);
-	});
-}
-
-}
-
-namespace
-{
-
 using namespace rapidjson;
 using namespace logger;
 using namespace std::literals;
@@ -70,6 +36,20 @@ std::string parse_config_str(Value const* const section, std::string_view member
 	return std::string(default_value);
 }
 
+size_t parse_config_size(Value const* const section, std::string_view member_name, size_t default_value)
+{
+	if (!section->HasMember(member_name.data()))
+		return default_value;
+
+	if (!(*section)[member_name.data()].IsUint64())
+	{
+		warning(std::format("\"{}\" must be an unsigned integer. Default value will be assigned.", member_name));
+		return default_value;
+	}
+
+	return static_cast<size_t>((*section)[member_name.data()].GetUint64());
+}
+
 std::string parse_log_file(Value const * const logger_section)
 {
 	std::string result = parse_config_str(logger_section, "log_file", "");
@@ -89,21 +69,100 @@ std::string parse_log_pattern(Value const * const logger_section)
 	return parse_config_str(logger_section, "log_pattern", DEFAULT_LOG_PATTERN);
 }
 
+size_t parse_async_queue_size(Value const * const logger_section)
+{
+	return parse_config_size(logger_section, "async_queue_size", DEFAULT_ASYNC_QUEUE_SIZE);
+}
+
+size_t parse_file_buffer_size(Value const * const logger_section)
+{
+	return parse_config_size(logger_section, "file_buffer_size", DEFAULT_FILE_BUFFER_SIZE);
+}
+
+std::chrono::milliseconds parse_flush_interval(Value const * const logger_section)
+{
+	return std::chrono::milliseconds(parse_config_size(logger_section, "flush_interval_ms", DEFAULT_FLUSH_INTERVAL.count()));
+}
+
+Level parse_flush_level(Value const * const logger_section)
+{
+	return str_to_level(parse_config_str(logger_section, "flush_level", level_to_str(DEFAULT_FLUSH_LEVEL)));
+}
+
+size_t parse_mmap_segment_size(Value const * const logger_section)
+{
+	return parse_config_size(logger_section, "mmap_segment_size", DEFAULT_MMAP_SEGMENT_SIZE);
+}
+
+size_t parse_max_file_size(Value const * const logger_section)
+{
+	return parse_config_size(logger_section, "max_file_size", DEFAULT_MAX_FILE_SIZE);
+}
+
+size_t parse_max_files(Value const * const logger_section)
+{
+	return parse_config_size(logger_section, "max_files", DEFAULT_MAX_FILES);
+}
+
+RotationInterval parse_rotation_interval(Value const * const logger_section)
+{
+	return str_to_rotation_interval(parse_config_str(logger_section, "rotation_interval", "none"));
+}
+
+Compression parse_compression(Value const * const logger_section)
+{
+	return str_to_compression(parse_config_str(logger_section, "compression", "none"));
+}
+
+int parse_compression_level(Value const * const logger_section)
+{
+	const size_t level = parse_config_size(logger_section, "compression_level", DEFAULT_COMPRESSION_LEVEL);
+
+	// large values would wrap into the range when narrowed, so they are kept out of it for the validator
+	return static_cast<int>(std::min(level, static_cast<size_t>(MAX_COMPRESSION_LEVEL) + 1));
+}
+
+size_t parse_compression_threads(Value const * const logger_section)
+{
+	return parse_config_size(logger_section, "compression_threads", DEFAULT_COMPRESSION_THREADS);
+}
+
+ThreadIdType parse_thread_id_type(Value const * const logger_section)
+{
+	return str_to_thread_id_type(parse_config_str(logger_section, "thread_id", "std"));
+}
+
 bool validate_config_log_pattern(const LoggerConfig& config)
 {
-	std::string log_pattern = copy(config.log_pattern);
-	replace_log_pattern_placeholders(log_pattern);
+	std::string text;
+	std::vector<PatternToken> tokens;
 
-	try
-	{
-		(void)std::vformat(log_pattern, std::make_format_args("0"sv, "1"sv, "2"sv, "3"sv));
-	}
-	catch (const std::format_error&)
-	{
-		return false;
-	}
+	return compile_log_pattern(config.log_pattern, text, tokens);
+}
+
+bool validate_config_async_queue_size(const LoggerConfig& config)
+{
+	return config.async_queue_size > 0;
+}
+
+bool validate_config_mmap_segment_size(const LoggerConfig& config)
+{
+	return config.mmap_segment_size > 0;
+}
+
+bool validate_config_max_files(const LoggerConfig& config)
+{
+	return config.max_files > 0;
+}
 
-	return true;
+bool validate_config_compression_level(const LoggerConfig& config)
+{
+	return config.compression_level >= MIN_COMPRESSION_LEVEL && config.compression_level <= MAX_COMPRESSION_LEVEL;
+}
+
+bool validate_config_compression_threads(const LoggerConfig& config)
+{
+	return config.compression_threads > 0;
 }
 
 } // namespace
@@ -111,6 +170,31 @@ bool validate_config_log_pattern(const LoggerConfig& config)
 namespace logger
 {
 
+RotationInterval str_to_rotation_interval(const std::string_view interval_str)
+{
+	if (interval_str == "none")
+		return RotationInterval::NONE;
+
+	if (interval_str == "hourly")
+		return RotationInterval::HOURLY;
+
+	if (interval_str == "daily")
+		return RotationInterval::DAILY;
+
+	throw std::runtime_error("unknown rotation interval string");
+}
+
+Compression str_to_compression(const std::string_view compression_str)
+{
+	if (compression_str == "none")
+		return Compression::NONE;
+
+	if (compression_str == "gzip")
+		return Compression::GZIP;
+
+	throw std::runtime_error("unknown compression string");
+}
+
 LoggerConfig logger::read_config(const fs::path& file)
 {
 	const std::string json_text = read_file(file);
@@ -152,6 +236,30 @@ LoggerConfig read_config_from_json(const std::string& json_text)
 
 	config.log_pattern = parse_log_pattern(logger_section);
 
+	config.async_queue_size = parse_async_queue_size(logger_section);
+
+	config.thread_id_type = parse_thread_id_type(logger_section);
+
+	config.file_buffer_size = parse_file_buffer_size(logger_section);
+
+	config.flush_interval = parse_flush_interval(logger_section);
+
+	config.flush_level = parse_flush_level(logger_section);
+
+	config.mmap_segment_size = parse_mmap_segment_size(logger_section);
+
+	config.max_file_size = parse_max_file_size(logger_section);
+
+	config.max_files = parse_max_files(logger_section);
+
+	config.rotation_interval = parse_rotation_interval(logger_section);
+
+	config.compression = parse_compression(logger_section);
+
+	config.compression_level = parse_compression_level(logger_section);
+
+	config.compression_threads = parse_compression_threads(logger_section);
+
 	return config;
 }
 
@@ -160,8 +268,13 @@ validation_result_t validate_config(const LoggerConfig& config)
 	using func_t = bool(const LoggerConfig&);
 	using value_t = std::pair<func_t*, std::string_view>;
 
-	static std::array<value_t, 1> validators = { {
-		{ &validate_config_log_pattern, "invalid log_pattern" },
+	static std::array<value_t, 6> validators = { {
+		{ &validate_config_log_pattern,         "invalid log_pattern" },
+		{ &validate_config_async_queue_size,    "async_queue_size must be greater than zero" },
+		{ &validate_config_mmap_segment_size,   "mmap_segment_size must be greater than zero" },
+		{ &validate_config_max_files,           "max_files must be greater than zero" },
+		{ &validate_config_compression_level,   "compression_level must be from 1 to 9" },
+		{ &validate_config_compression_threads, "compression_threads must be greater than zero" },
 	} };
 
 	bool result = true;
@@ -1,22 +1,77 @@
 #pragma once
 
 #include "log_level.hpp"
+#include "thread_info.hpp"
 
+#include <chrono>
+#include <cstdint>
 #include <filesystem>
 #include <string>
+#include <string_view>
 #include <tuple>
 
 namespace logger
 {
 
+enum class RotationInterval : uint8_t
+{
+	NONE,
+	HOURLY, // at the beginning of every hour
+	DAILY   // at midnight
+};
+
+/// <summary>
+/// Converting string representation of rotation interval ("none", "hourly" or "daily") to logger::RotationInterval enum value
+/// </summary>
+/// <exception cref="std::runtime_error">string representation is unknown</exception>
+RotationInterval str_to_rotation_interval(const std::string_view interval_str);
+
+enum class Compression : uint8_t
+{
+	NONE,
+	GZIP
+};
+
+/// <summary>
+/// Converting string representation of compression algorithm ("none" or "gzip") to logger::Compression enum value
+/// </summary>
+/// <exception cref="std::runtime_error">string representation is unknown</exception>
+Compression str_to_compression(const std::string_view compression_str);
+
+constexpr int MIN_COMPRESSION_LEVEL = 1;
+constexpr int MAX_COMPRESSION_LEVEL = 9;
+
 constexpr std::string_view DEFAULT_LOG_FILE = "log.log";
 constexpr std::string_view DEFAULT_LOG_PATTERN = "[{{time}}][[thread-id={{thread-id}}]][{{log-level}}] {{message}}";
+constexpr size_t DEFAULT_ASYNC_QUEUE_SIZE = 8192;
+constexpr size_t DEFAULT_FILE_BUFFER_SIZE = 64 * 1024;
+constexpr std::chrono::milliseconds DEFAULT_FLUSH_INTERVAL { 1000 };
+constexpr Level DEFAULT_FLUSH_LEVEL = Level::ERROR;
+constexpr size_t DEFAULT_MMAP_SEGMENT_SIZE = 64 * 1024 * 1024;
+constexpr size_t DEFAULT_MAX_FILE_SIZE = 100 * 1024 * 1024;
+constexpr size_t DEFAULT_MAX_FILES = 10;
+constexpr RotationInterval DEFAULT_ROTATION_INTERVAL = RotationInterval::NONE;
+constexpr Compression DEFAULT_COMPRESSION = Compression::NONE;
+constexpr int DEFAULT_COMPRESSION_LEVEL = 6;
+constexpr size_t DEFAULT_COMPRESSION_THREADS = 1;
 
 struct LoggerConfig
 {
-	Level log_level                     = DEFAULT_LOG_LEVEL;
-	std::filesystem::path log_file_path = DEFAULT_LOG_FILE;
-	std::string log_pattern             = std::string(DEFAULT_LOG_PATTERN);
+	Level log_level                          = DEFAULT_LOG_LEVEL;
+	std::filesystem::path log_file_path      = DEFAULT_LOG_FILE;
+	std::string log_pattern                  = std::string(DEFAULT_LOG_PATTERN);
+	size_t async_queue_size                  = DEFAULT_ASYNC_QUEUE_SIZE;
+	ThreadIdType thread_id_type              = DEFAULT_THREAD_ID_TYPE;
+	size_t file_buffer_size                  = DEFAULT_FILE_BUFFER_SIZE; // 0 - flush every entry
+	std::chrono::milliseconds flush_interval = DEFAULT_FLUSH_INTERVAL;   // 0 - no time limit
+	Level flush_level                        = DEFAULT_FLUSH_LEVEL;      // entries of the level and higher are flushed at once
+	size_t mmap_segment_size                 = DEFAULT_MMAP_SEGMENT_SIZE;
+	size_t max_file_size                     = DEFAULT_MAX_FILE_SIZE;    // 0 - no size limit
+	size_t max_files                         = DEFAULT_MAX_FILES;        // including the current one
+	RotationInterval rotation_interval       = DEFAULT_ROTATION_INTERVAL;
+	Compression compression                  = DEFAULT_COMPRESSION;      // of rotated files
+	int compression_level                    = DEFAULT_COMPRESSION_LEVEL;
+	size_t compression_threads               = DEFAULT_COMPRESSION_THREADS;
 };
 
 LoggerConfig read_config(const std::filesystem::path& file);
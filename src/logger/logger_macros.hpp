@@ -0,0 +1,24 @@
+#pragma once
+
+#include "log_level.hpp"
+
+#include <type_traits>
+
+// Logging macros for loggers with compile-time minimal level (see StaticMinLevel and LOGGER_STATIC_MIN_LEVEL).
+// Unlike Logger::debug() and others, the macros don't evaluate arguments of disabled levels at all:
+//
+//     LOGGER_DEBUG(log, "state: {}", expensive_dump());  // expensive_dump() isn't called for disabled DEBUG
+//
+// Runtime log_level from the configuration is checked by the logger as usual.
+
+#define LOGGER_LOG(log_object, level, ...)                                                    \
+	do                                                                                        \
+	{                                                                                         \
+		if constexpr (std::remove_cvref_t<decltype(log_object)>::is_enabled(level))           \
+			(log_object).log(level, __VA_ARGS__);                                             \
+	} while (false)
+
+#define LOGGER_DEBUG(log_object, ...)   LOGGER_LOG(log_object, ::logger::Level::DEBUG, __VA_ARGS__)
+#define LOGGER_INFO(log_object, ...)    LOGGER_LOG(log_object, ::logger::Level::INFO, __VA_ARGS__)
+#define LOGGER_WARNING(log_object, ...) LOGGER_LOG(log_object, ::logger::Level::WARNING, __VA_ARGS__)
+#define LOGGER_ERROR(log_object, ...)   LOGGER_LOG(log_object, ::logger::Level::ERROR, __VA_ARGS__)
@@ -0,0 +1,145 @@
+#include "mapped_file.hpp"
+
+#include <format>
+#include <stdexcept>
+#include <string>
+
+#if defined(_WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#define NOGDI
+	#include <windows.h>
+#else
+	#include <cerrno>
+	#include <cstring>
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <unistd.h>
+#endif
+
+namespace logger
+{
+
+MappedFile::~MappedFile()
+{
+	if (is_open())
+		close(capacity_);
+}
+
+#if defined(_WIN32)
+
+void MappedFile::open(const std::filesystem::path& path, size_t capacity)
+{
+	if (is_open())
+		close(capacity_);
+
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+							  CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		throw std::runtime_error(std::format("can't create file \"{}\": error {}", path.string(), GetLastError()));
+
+	// the mapping of the specified size extends the file, so disk space is allocated here
+	const auto size = static_cast<ULONGLONG>(capacity);
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(size >> 32), static_cast<DWORD>(size), nullptr);
+	if (mapping == nullptr)
+	{
+		const DWORD error = GetLastError();
+		CloseHandle(file);
+		throw std::runtime_error(std::format("can't preallocate file \"{}\": error {}", path.string(), error));
+	}
+
+	void* data = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, capacity);
+	if (data == nullptr)
+	{
+		const DWORD error = GetLastError();
+		CloseHandle(mapping);
+		CloseHandle(file);
+		throw std::runtime_error(std::format("can't map file \"{}\": error {}", path.string(), error));
+	}
+
+	file_ = file;
+	mapping_ = mapping;
+	data_ = static_cast<char*>(data);
+	capacity_ = capacity;
+}
+
+void MappedFile::close(size_t used_size)
+{
+	if (!is_open())
+		return;
+
+	UnmapViewOfFile(data_);
+	CloseHandle(mapping_);
+
+	LARGE_INTEGER size;
+	size.QuadPart = static_cast<LONGLONG>(used_size);
+	if (SetFilePointerEx(file_, size, nullptr, FILE_BEGIN))
+		SetEndOfFile(file_);
+
+	CloseHandle(file_);
+
+	file_ = nullptr;
+	mapping_ = nullptr;
+	data_ = nullptr;
+	capacity_ = 0;
+}
+
+#else
+
+void MappedFile::open(const std::filesystem::path& path, size_t capacity)
+{
+	if (is_open())
+		close(capacity_);
+
+	const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (fd < 0)
+		throw std::runtime_error(std::format("can't create file \"{}\": {}", path.string(), std::strerror(errno)));
+
+	const auto size = static_cast<off_t>(capacity);
+
+#if defined(__linux__)
+	// posix_fallocate reserves disk blocks, so page faults on writing don't allocate them;
+	// fall back to ftruncate on file systems that don't support it
+	int result = posix_fallocate(fd, 0, size);
+	if (result != 0)
+		result = ::ftruncate(fd, size) == 0 ? 0 : errno;
+#else
+	const int result = ::ftruncate(fd, size) == 0 ? 0 : errno;
+#endif
+
+	if (result != 0)
+	{
+		::close(fd);
+		throw std::runtime_error(std::format("can't preallocate file \"{}\": {}", path.string(), std::strerror(result)));
+	}
+
+	void* data = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (data == MAP_FAILED)
+	{
+		const int error = errno;
+		::close(fd);
+		throw std::runtime_error(std::format("can't map file \"{}\": {}", path.string(), std::strerror(error)));
+	}
+
+	fd_ = fd;
+	data_ = static_cast<char*>(data);
+	capacity_ = capacity;
+}
+
+void MappedFile::close(size_t used_size)
+{
+	if (!is_open())
+		return;
+
+	::munmap(data_, capacity_);
+	(void) ::ftruncate(fd_, static_cast<off_t>(used_size));
+	::close(fd_);
+
+	fd_ = -1;
+	data_ = nullptr;
+	capacity_ = 0;
+}
+
+#endif
+
+} // namespace logger
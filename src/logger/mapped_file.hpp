@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+namespace logger
+{
+
+/// <summary>
+/// File of the fixed size that is preallocated on disk and mapped to memory for writing
+/// </summary>
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile(MappedFile&&) = delete;
+	MappedFile& operator=(MappedFile&&) = delete;
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	/// <summary>
+	/// Create (or overwrite) the file, preallocate disk space for it and map it to memory
+	/// </summary>
+	/// <exception cref="std::runtime_error">file can't be created, preallocated or mapped</exception>
+	void open(const std::filesystem::path& path, size_t capacity);
+
+	/// <summary>
+	/// Unmap the file and truncate it to the used size
+	/// </summary>
+	void close(size_t used_size);
+
+	bool is_open() const { return data_ != nullptr; }
+
+	char* data() const { return data_; }
+	size_t capacity() const { return capacity_; }
+
+private:
+	char* data_ = nullptr;
+	size_t capacity_ = 0;
+
+#if defined(_WIN32)
+	void* file_ = nullptr;
+	void* mapping_ = nullptr;
+#else
+	int fd_ = -1;
+#endif
+};
+
+} // namespace logger
@@ -0,0 +1,284 @@
+#include "mmap_file_policy.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+// creation of the next segment is retried with the growing delay while entries are dropped
+constexpr std::chrono::milliseconds MIN_RETRY_DELAY { 10 };
+constexpr std::chrono::milliseconds MAX_RETRY_DELAY { 1000 };
+
+} // namespace
+
+namespace logger
+{
+
+std::atomic<MmapFileLoggerPolicy::Segment*> MmapFileLoggerPolicy::current_ = nullptr;
+
+std::mutex MmapFileLoggerPolicy::mutex_;
+std::condition_variable MmapFileLoggerPolicy::cv_;
+fs::path MmapFileLoggerPolicy::file_path_;
+size_t MmapFileLoggerPolicy::segment_size_ = DEFAULT_MMAP_SEGMENT_SIZE;
+size_t MmapFileLoggerPolicy::next_index_ = 0;
+MmapFileLoggerPolicy::Segment* MmapFileLoggerPolicy::next_ = nullptr;
+bool MmapFileLoggerPolicy::next_failed_ = false;
+std::vector<MmapFileLoggerPolicy::Segment*> MmapFileLoggerPolicy::filled_;
+bool MmapFileLoggerPolicy::stop_ = false;
+std::thread MmapFileLoggerPolicy::background_;
+std::deque<std::unique_ptr<MmapFileLoggerPolicy::Segment>> MmapFileLoggerPolicy::segments_;
+std::deque<std::unique_ptr<MmapFileLoggerPolicy::Segment>> MmapFileLoggerPolicy::retired_;
+
+void MmapFileLoggerPolicy::set_file_path(const fs::path& file_path)
+{
+	release();
+
+	std::scoped_lock lock(mutex_);
+
+	file_path_ = file_path;
+	next_index_ = 0;
+	while (fs::exists(segment_path(file_path_, next_index_)))
+		++next_index_;
+
+	std::unique_ptr<Segment> segment = create_segment(next_index_++, segment_size_);
+	current_.store(segment.get(), std::memory_order_release);
+	segments_.push_back(std::move(segment));
+
+	background_ = std::thread(&MmapFileLoggerPolicy::background_loop);
+}
+
+fs::path MmapFileLoggerPolicy::segment_path(const fs::path& file_path, size_t index)
+{
+	fs::path result = file_path;
+	result.replace_filename(file_path.stem().string() + "." + std::to_string(index) + file_path.extension().string());
+
+	return result;
+}
+
+void MmapFileLoggerPolicy::configure(const LoggerConfig& config)
+{
+	std::scoped_lock lock(mutex_);
+
+	// applied to segments created later
+	segment_size_ = config.mmap_segment_size;
+}
+
+void MmapFileLoggerPolicy::release()
+{
+	{
+		std::scoped_lock lock(mutex_);
+		stop_ = true;
+	}
+
+	cv_.notify_all();
+
+	if (background_.joinable())
+		background_.join();
+
+	std::scoped_lock lock(mutex_);
+
+	if (Segment* segment = current_.exchange(nullptr, std::memory_order_acq_rel))
+	{
+		current_.notify_all();
+		cv_.notify_all();
+
+		segment->used = seal_segment(segment);
+		finish_segment(segment);
+	}
+
+	for (Segment* segment : filled_)
+		finish_segment(segment);
+
+	// the prepared segment was never written
+	if (next_ != nullptr)
+	{
+		next_->file.close(0);
+		fs::remove(segment_path(file_path_, next_->index));
+	}
+
+	filled_.clear();
+	next_ = nullptr;
+	next_failed_ = false;
+	stop_ = false;
+
+	retired_ = std::move(segments_);
+	segments_.clear();
+}
+
+void MmapFileLoggerPolicy::write(const std::string_view message)
+{
+	Segment* segment = current_.load(std::memory_order_acquire);
+
+	while (segment != nullptr)
+	{
+		const size_t capacity = segment->capacity;
+		const std::string_view line = message.substr(0, capacity - 1);
+		const size_t size = line.size() + 1;
+
+		const size_t offset = segment->reserved.fetch_add(size, std::memory_order_relaxed);
+
+		if (offset + size <= capacity)
+		{
+			char* out = segment->data + offset;
+			std::memcpy(out, line.data(), line.size());
+			out[line.size()] = '\n';
+
+			segment->committed.fetch_add(size, std::memory_order_release);
+			return;
+		}
+
+		// ranges are reserved one after another, so only one writer gets the range crossing the end:
+		// it switches segments and others wait for that
+		if (offset <= capacity)
+		{
+			segment->crossing_offset.store(offset, std::memory_order_release);
+			switch_segment(segment, offset);
+		}
+		else
+			current_.wait(segment, std::memory_order_acquire);
+
+		segment = current_.load(std::memory_order_acquire);
+	}
+}
+
+std::unique_ptr<MmapFileLoggerPolicy::Segment> MmapFileLoggerPolicy::create_segment(size_t index, size_t size)
+{
+	auto segment = std::make_unique<Segment>();
+	segment->index = index;
+	segment->file.open(segment_path(file_path_, index), size);
+	segment->data = segment->file.data();
+	segment->capacity = segment->file.capacity();
+
+	return segment;
+}
+
+void MmapFileLoggerPolicy::switch_segment(Segment* filled, size_t used)
+{
+	std::unique_lock lock(mutex_);
+
+	// released while the writer was waiting for the lock or the next segment
+	// (stop_ is reset by the end of release, so the writer could miss it)
+	cv_.wait(lock, [filled] { return current_.load(std::memory_order_relaxed) != filled || next_ != nullptr || next_failed_ || stop_; });
+
+	if (current_.load(std::memory_order_relaxed) != filled)
+		return;
+
+	filled->used = used;
+	filled_.push_back(filled);
+
+	// entries are dropped if the next segment can't be created or the policy is being released
+	current_.store(next_, std::memory_order_release);
+	next_ = nullptr;
+
+	lock.unlock();
+
+	current_.notify_all();
+	cv_.notify_all();
+}
+
+size_t MmapFileLoggerPolicy::seal_segment(Segment* segment)
+{
+	// later ranges start after the end, so their writers don't touch the segment data
+	const size_t reserved = segment->reserved.fetch_add(segment->capacity + 1, std::memory_order_acq_rel);
+	if (reserved <= segment->capacity)
+		return reserved;
+
+	// ranges before the crossing one are committed without the lock, so it is the used size;
+	// its writer publishes it right after the reservation
+	size_t offset;
+	while ((offset = segment->crossing_offset.load(std::memory_order_acquire)) == Segment::NO_OFFSET)
+		std::this_thread::yield();
+
+	return offset;
+}
+
+void MmapFileLoggerPolicy::finish_segment(Segment* segment)
+{
+	while (segment->committed.load(std::memory_order_acquire) < segment->used)
+		std::this_thread::yield();
+
+	segment->file.close(segment->used);
+}
+
+void MmapFileLoggerPolicy::background_loop()
+{
+	std::unique_lock lock(mutex_);
+	std::chrono::milliseconds retry_delay = MIN_RETRY_DELAY;
+
+	for (;;)
+	{
+		cv_.wait(lock, [] { return stop_ || !filled_.empty() || (next_ == nullptr && !next_failed_); });
+
+		if (!filled_.empty())
+		{
+			std::vector<Segment*> filled;
+			filled.swap(filled_);
+
+			lock.unlock();
+
+			for (Segment* segment : filled)
+				finish_segment(segment);
+
+			lock.lock();
+			continue;
+		}
+
+		if (stop_)
+			break;
+
+		const size_t index = next_index_;
+		const size_t size = segment_size_;
+
+		lock.unlock();
+
+		std::unique_ptr<Segment> segment;
+		try
+		{
+			segment = create_segment(index, size);
+		}
+		catch (const std::exception& e)
+		{
+			std::cerr << "Error: " << e.what() << std::endl;
+		}
+
+		lock.lock();
+
+		if (!segment)
+		{
+			// writers drop entries instead of waiting until the retry
+			next_failed_ = true;
+			cv_.notify_all();
+
+			cv_.wait_for(lock, retry_delay, [] { return stop_; });
+			retry_delay = std::min(retry_delay * 2, MAX_RETRY_DELAY);
+
+			next_failed_ = false;
+			continue;
+		}
+
+		++next_index_;
+		retry_delay = MIN_RETRY_DELAY;
+
+		// the segment was switched to nothing after a failure: writers go on with the new one
+		if (current_.load(std::memory_order_relaxed) == nullptr && !stop_)
+		{
+			current_.store(segment.get(), std::memory_order_release);
+			current_.notify_all();
+		}
+		else
+		{
+			next_ = segment.get();
+		}
+
+		segments_.push_back(std::move(segment));
+		cv_.notify_all();
+	}
+}
+
+} // namespace logger
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "logger_concepts.hpp"
+#include "logger_config.hpp"
+#include "mapped_file.hpp"
+#include "mpsc_queue.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace logger
+{
+
+/// <summary>
+/// File policy that writes to memory-mapped segment files preallocated on disk.
+/// Writers reserve byte ranges of the current segment with an atomic fetch-add and copy entries there,
+/// so there are no locks and no system calls per entry. The background thread prepares the next segment
+/// in advance and truncates filled segments to their used size. Segments of "log.log" are "log.0.log",
+/// "log.1.log" and so on (see segment_path); their size is mmap_segment_size from the configuration.
+/// Entries longer than the segment are truncated.
+/// </summary>
+class MmapFileLoggerPolicy
+{
+public:
+	using concurrent_policy_tag = void;
+
+	/// <summary>
+	/// Start writing to segments of the file. Numbering continues after existing segments.
+	/// </summary>
+	/// <exception cref="std::runtime_error">the first segment can't be created</exception>
+	static void set_file_path(const std::filesystem::path& file_path);
+
+	/// <summary>
+	/// Path of the segment file with the specified index
+	/// </summary>
+	static std::filesystem::path segment_path(const std::filesystem::path& file_path, size_t index);
+
+	static void configure(const LoggerConfig& config);
+
+	/// <summary>
+	/// Wait until started writes are finished, stop the background thread and truncate all segments
+	/// </summary>
+	static void release();
+
+	static void write(const std::string_view message);
+
+private:
+	struct Segment
+	{
+		static constexpr size_t NO_OFFSET = SIZE_MAX;
+
+		MappedFile file;
+
+		// copies of the mapping for writers: they don't change until the segment is freed,
+		// while the file itself is closed when late writers could still read them
+		char* data = nullptr;
+		size_t capacity = 0;
+
+		size_t index = 0;
+		size_t used = 0; // final size, known when the segment is filled
+		alignas(CACHE_LINE_SIZE) std::atomic<size_t> reserved = 0;
+		alignas(CACHE_LINE_SIZE) std::atomic<size_t> committed = 0;
+
+		// offset of the range crossing the end, the writer of that range publishes it before taking the lock
+		std::atomic<size_t> crossing_offset = NO_OFFSET;
+	};
+
+	static std::unique_ptr<Segment> create_segment(size_t index, size_t size);
+	static void switch_segment(Segment* filled, size_t used);
+	static void finish_segment(Segment* segment);
+	static size_t seal_segment(Segment* segment);
+	static void background_loop();
+
+	static std::atomic<Segment*> current_;
+
+	static std::mutex mutex_;
+	static std::condition_variable cv_;
+	static std::filesystem::path file_path_;
+	static size_t segment_size_;
+	static size_t next_index_;
+	static Segment* next_;
+	static bool next_failed_;
+	static std::vector<Segment*> filled_;
+	static bool stop_;
+	static std::thread background_;
+
+	// segments are not deleted until release: late writers could still touch their counters;
+	// segments of the released file are kept until the next release for writers that loaded them before it
+	static std::deque<std::unique_ptr<Segment>> segments_;
+	static std::deque<std::unique_ptr<Segment>> retired_;
+};
+
+static_assert(concurrent_policy<MmapFileLoggerPolicy>);
+static_assert(configurable_policy<MmapFileLoggerPolicy>);
+static_assert(releasable_policy<MmapFileLoggerPolicy>);
+
+} // namespace logger
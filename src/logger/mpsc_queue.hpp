@@ -0,0 +1,146 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace logger
+{
+
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+/// <summary>
+/// Bounded lock-free multi-producer single-consumer queue.
+/// Every cell carries a sequence number, so producers only contend on the enqueue position
+/// and the consumer never takes a lock (see D. Vyukov's bounded MPMC queue).
+/// </summary>
+/// <typeparam name="T">move assignable and default constructible value type</typeparam>
+template<class T>
+class MpscQueue
+{
+public:
+	/// <param name="capacity">queue capacity, rounded up to the next power of two</param>
+	explicit MpscQueue(size_t capacity);
+
+	MpscQueue(MpscQueue&&) = delete;
+	MpscQueue& operator=(MpscQueue&&) = delete;
+	MpscQueue(const MpscQueue&) = delete;
+	MpscQueue& operator=(const MpscQueue&) = delete;
+
+	/// <summary>
+	/// Push value to the queue. Could be called from any thread.
+	/// </summary>
+	/// <returns>false if queue is full, value stays untouched in that case</returns>
+	bool try_push(T&& value);
+
+	/// <summary>
+	/// Pop value from the queue. Must be called only from the consumer thread.
+	/// </summary>
+	/// <returns>false if queue is empty</returns>
+	bool try_pop(T& value);
+
+	/// <summary>
+	/// Check if there is no published value at the head of the queue. Consumer thread only.
+	/// </summary>
+	bool empty() const;
+
+	/// <summary>
+	/// Count of push operations that reserved a cell since the queue creation.
+	/// </summary>
+	size_t enqueued() const { return enqueue_pos_.load(std::memory_order_acquire); }
+
+	size_t capacity() const { return mask_ + 1; }
+
+private:
+	struct Cell
+	{
+		std::atomic<size_t> sequence;
+		T value;
+	};
+
+	static size_t round_up_capacity(size_t capacity);
+
+	alignas(CACHE_LINE_SIZE) std::atomic<size_t> enqueue_pos_ = 0;
+	alignas(CACHE_LINE_SIZE) size_t dequeue_pos_ = 0;
+	alignas(CACHE_LINE_SIZE) const size_t mask_;
+	const std::unique_ptr<Cell[]> cells_;
+};
+
+template<class T>
+inline MpscQueue<T>::MpscQueue(size_t capacity)
+	: mask_(round_up_capacity(capacity) - 1)
+	, cells_(std::make_unique<Cell[]>(mask_ + 1))
+{
+	for (size_t i = 0; i <= mask_; ++i)
+		cells_[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+template<class T>
+inline bool MpscQueue<T>::try_push(T&& value)
+{
+	size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+
+	for (;;)
+	{
+		Cell& cell = cells_[pos & mask_];
+		const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+		const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+
+		if (diff == 0)
+		{
+			if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+			{
+				cell.value = std::move(value);
+				cell.sequence.store(pos + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (diff < 0)
+		{
+			return false;
+		}
+		else
+		{
+			pos = enqueue_pos_.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+template<class T>
+inline bool MpscQueue<T>::try_pop(T& value)
+{
+	Cell& cell = cells_[dequeue_pos_ & mask_];
+	const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+
+	if (sequence != dequeue_pos_ + 1)
+		return false;
+
+	value = std::move(cell.value);
+	cell.sequence.store(dequeue_pos_ + mask_ + 1, std::memory_order_release);
+	++dequeue_pos_;
+
+	return true;
+}
+
+template<class T>
+inline bool MpscQueue<T>::empty() const
+{
+	return cells_[dequeue_pos_ & mask_].sequence.load(std::memory_order_acquire) != dequeue_pos_ + 1;
+}
+
+template<class T>
+inline size_t MpscQueue<T>::round_up_capacity(size_t capacity)
+{
+	if (capacity == 0)
+		throw std::invalid_argument("queue capacity must be greater than zero");
+
+	size_t result = 1;
+	while (result < capacity)
+		result <<= 1;
+
+	return result;
+}
+
+} // namespace logger
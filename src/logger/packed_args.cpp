@@ -0,0 +1,155 @@
+#include "packed_args.hpp"
+
+#include <vector>
+
+namespace
+{
+
+using namespace logger;
+
+// size of the packed argument after its tag
+size_t packed_value_size(ArgTag tag, const std::byte* value, const std::byte* end)
+{
+	switch (tag)
+	{
+	case ArgTag::BOOL:    return sizeof(bool);
+	case ArgTag::CHAR:    return sizeof(char);
+	case ArgTag::INT:     return sizeof(int64_t);
+	case ArgTag::UINT:    return sizeof(uint64_t);
+	case ArgTag::FLOAT:   return sizeof(float);
+	case ArgTag::DOUBLE:  return sizeof(double);
+	case ArgTag::POINTER: return sizeof(const void*);
+	case ArgTag::STRING:
+	{
+		if (end - value < static_cast<ptrdiff_t>(sizeof(uint64_t)))
+			throw std::format_error("packed arguments are corrupted");
+
+		uint64_t size;
+		std::memcpy(&size, value, sizeof(size));
+
+		// checked before the addition, so a corrupted size can't overflow
+		if (size > static_cast<uint64_t>(end - value) - sizeof(size))
+			throw std::format_error("packed arguments are corrupted");
+
+		return sizeof(size) + static_cast<size_t>(size);
+	}
+	}
+
+	throw std::format_error("unknown packed argument tag");
+}
+
+template<class T>
+void format_value(std::string& out, const std::string& field, const std::byte* data)
+{
+	const T value = internal::unpack_arg<T>(data);
+	std::vformat_to(std::back_inserter(out), field, std::make_format_args(value));
+}
+
+void format_arg(std::string& out, const std::string& field, const std::byte* data)
+{
+	ArgTag tag;
+	std::memcpy(&tag, data, sizeof(tag));
+
+	switch (tag)
+	{
+	case ArgTag::BOOL:    format_value<bool>(out, field, data); break;
+	case ArgTag::CHAR:    format_value<char>(out, field, data); break;
+	case ArgTag::INT:     format_value<int64_t>(out, field, data); break;
+	case ArgTag::UINT:    format_value<uint64_t>(out, field, data); break;
+	case ArgTag::FLOAT:   format_value<float>(out, field, data); break;
+	case ArgTag::DOUBLE:  format_value<double>(out, field, data); break;
+	case ArgTag::STRING:  format_value<std::string_view>(out, field, data); break;
+	case ArgTag::POINTER: format_value<const void*>(out, field, data); break;
+	}
+}
+
+} // namespace
+
+namespace logger
+{
+
+void format_tagged_args(std::string& out, std::string_view format, std::span<const std::byte> args)
+{
+	// positions of arguments, so fields could refer to them by index
+	std::vector<const std::byte*> positions;
+
+	const std::byte* const end = args.data() + args.size();
+	for (const std::byte* data = args.data(); data < end; )
+	{
+		ArgTag tag;
+		std::memcpy(&tag, data, sizeof(tag));
+
+		const size_t size = sizeof(tag) + packed_value_size(tag, data + sizeof(tag), end);
+		if (static_cast<size_t>(end - data) < size)
+			throw std::format_error("packed arguments are corrupted");
+
+		positions.push_back(data);
+		data += size;
+	}
+
+	std::string field;
+	size_t next_arg = 0;
+
+	for (size_t i = 0; i < format.size(); ++i)
+	{
+		const char c = format[i];
+
+		if (c == '}')
+		{
+			if (i + 1 < format.size() && format[i + 1] == '}')
+				++i;
+
+			out.push_back('}');
+			continue;
+		}
+
+		if (c != '{')
+		{
+			out.push_back(c);
+			continue;
+		}
+
+		if (i + 1 < format.size() && format[i + 1] == '{')
+		{
+			out.push_back('{');
+			++i;
+			continue;
+		}
+
+		const size_t close = format.find('}', i + 1);
+		const std::string_view content = format.substr(i + 1, close == std::string_view::npos ? std::string_view::npos : close - i - 1);
+
+		if (close == std::string_view::npos || content.find('{') != std::string_view::npos)
+			throw std::format_error("unsupported replacement field in the format string");
+
+		// "{index:spec}" is formatted as "{:spec}" with the single argument
+		const size_t colon = content.find(':');
+		const std::string_view index = content.substr(0, colon);
+
+		size_t arg = next_arg++;
+		if (!index.empty())
+		{
+			arg = 0;
+			for (const char digit : index)
+			{
+				if (digit < '0' || digit > '9')
+					throw std::format_error("unsupported argument id in the format string");
+
+				arg = arg * 10 + static_cast<size_t>(digit - '0');
+			}
+		}
+
+		if (arg >= positions.size())
+			throw std::format_error("argument index is out of range");
+
+		field.assign("{");
+		if (colon != std::string_view::npos)
+			field.append(content.substr(colon));
+		field.push_back('}');
+
+		format_arg(out, field, positions[arg]);
+		i = close;
+	}
+}
+
+} // namespace logger
@@ -0,0 +1,393 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace logger
+{
+
+/// <summary>
+/// Type tag written before every packed argument, so packed arguments could be decoded
+/// without knowing original C++ types.
+/// </summary>
+enum class ArgTag : uint8_t
+{
+	BOOL,
+	CHAR,
+	INT,
+	UINT,
+	FLOAT,
+	DOUBLE,
+	STRING,
+	POINTER
+};
+
+namespace internal
+{
+
+template<class T>
+concept string_like_arg = std::convertible_to<const T&, std::string_view>;
+
+template<class T>
+struct packed_type
+{
+};
+
+template<>
+struct packed_type<bool>
+{
+	using type = bool;
+	static constexpr ArgTag tag = ArgTag::BOOL;
+};
+
+template<>
+struct packed_type<char>
+{
+	using type = char;
+	static constexpr ArgTag tag = ArgTag::CHAR;
+};
+
+template<class T>
+	requires std::signed_integral<T> && (!std::same_as<T, char>)
+struct packed_type<T>
+{
+	using type = int64_t;
+	static constexpr ArgTag tag = ArgTag::INT;
+};
+
+template<class T>
+	requires std::unsigned_integral<T> && (!std::same_as<T, bool>) && (!std::same_as<T, char>)
+struct packed_type<T>
+{
+	using type = uint64_t;
+	static constexpr ArgTag tag = ArgTag::UINT;
+};
+
+template<>
+struct packed_type<float>
+{
+	using type = float;
+	static constexpr ArgTag tag = ArgTag::FLOAT;
+};
+
+// long double isn't packed: it would lose precision as double and its size differs between compilers,
+// so it is formatted on the calling thread
+template<>
+struct packed_type<double>
+{
+	using type = double;
+	static constexpr ArgTag tag = ArgTag::DOUBLE;
+};
+
+template<class T>
+	requires string_like_arg<T>
+struct packed_type<T>
+{
+	using type = std::string_view;
+	static constexpr ArgTag tag = ArgTag::STRING;
+};
+
+template<class T>
+	requires std::is_pointer_v<T> && (!string_like_arg<T>)
+struct packed_type<T>
+{
+	using type = const void*;
+	static constexpr ArgTag tag = ArgTag::POINTER;
+};
+
+template<>
+struct packed_type<std::nullptr_t>
+{
+	using type = const void*;
+	static constexpr ArgTag tag = ArgTag::POINTER;
+};
+
+} // namespace internal
+
+/// <summary>
+/// Argument could be copied into the binary buffer and formatted later on an other thread
+/// </summary>
+template<class T>
+concept packable_arg = requires
+{
+	typename internal::packed_type<std::remove_cvref_t<std::decay_t<T>>>::type;
+};
+
+template<class T>
+using packed_arg_t = typename internal::packed_type<std::remove_cvref_t<std::decay_t<T>>>::type;
+
+template<class T>
+constexpr ArgTag packed_arg_tag_v = internal::packed_type<std::remove_cvref_t<std::decay_t<T>>>::tag;
+
+/// <summary>
+/// Storage of a producer thread for packs of arguments that don't fit into ArgsBuffer inline storage:
+/// BLOCK_COUNT blocks of BLOCK_SIZE bytes allocated at once. Only the owner thread takes blocks, any thread
+/// returns them (the writer thread of AsyncLogger, when a record is written), so steady logging of long
+/// arguments doesn't allocate memory. The arena lives while its thread or any of its blocks is alive.
+/// </summary>
+class ArgsArena
+{
+public:
+	static constexpr size_t BLOCK_SIZE = 1024;
+	static constexpr size_t BLOCK_COUNT = 64;
+
+	/// <summary>
+	/// Arena of the calling thread, allocated at the first call
+	/// </summary>
+	static const std::shared_ptr<ArgsArena>& this_thread_arena()
+	{
+		thread_local const std::shared_ptr<ArgsArena> arena = std::make_shared<ArgsArena>();
+		return arena;
+	}
+
+	/// <summary>
+	/// Take a free block. Must be called by the owner thread only.
+	/// </summary>
+	/// <returns>nullptr, if all blocks are in use</returns>
+	std::byte* acquire()
+	{
+		const uint64_t free = free_.load(std::memory_order_acquire);
+		if (free == 0)
+			return nullptr;
+
+		const int index = std::countr_zero(free);
+		free_.fetch_and(~(uint64_t(1) << index), std::memory_order_relaxed);
+
+		return storage_.get() + index * BLOCK_SIZE;
+	}
+
+	void release(const std::byte* block)
+	{
+		const auto index = static_cast<size_t>(block - storage_.get()) / BLOCK_SIZE;
+		free_.fetch_or(uint64_t(1) << index, std::memory_order_release);
+	}
+
+private:
+	static_assert(BLOCK_COUNT <= 64, "free blocks are bits of uint64_t");
+
+	const std::unique_ptr<std::byte[]> storage_ = std::make_unique<std::byte[]>(BLOCK_SIZE * BLOCK_COUNT);
+	std::atomic<uint64_t> free_ = BLOCK_COUNT == 64 ? ~uint64_t(0) : (uint64_t(1) << BLOCK_COUNT) - 1;
+};
+
+/// <summary>
+/// Byte buffer with inline storage for small packs of arguments. Larger packs take a block of the arena
+/// of the calling thread (see ArgsArena); packs larger than a block or packed while all blocks are in use
+/// go to the heap buffer, which keeps its capacity for the next packs.
+/// </summary>
+class ArgsBuffer
+{
+public:
+	static constexpr size_t INLINE_CAPACITY = 128;
+
+	ArgsBuffer() = default;
+	~ArgsBuffer() { release_block(); }
+
+	ArgsBuffer(ArgsBuffer&& other) noexcept { *this = std::move(other); }
+	ArgsBuffer& operator=(ArgsBuffer&& other) noexcept
+	{
+		release_block();
+
+		size_ = std::exchange(other.size_, 0);
+		data_ = std::exchange(other.data_, nullptr);
+		heap_ = std::move(other.heap_);
+		heap_capacity_ = std::exchange(other.heap_capacity_, 0);
+		arena_ = std::move(other.arena_);
+
+		if (!data_)
+			std::memcpy(inline_.data(), other.inline_.data(), size_);
+
+		return *this;
+	}
+
+	ArgsBuffer(const ArgsBuffer&) = delete;
+	ArgsBuffer& operator=(const ArgsBuffer&) = delete;
+
+	/// <summary>
+	/// Drop previous content and provide uninitialized storage of the specified size
+	/// </summary>
+	std::byte* resize(size_t size)
+	{
+		release_block();
+		size_ = size;
+
+		if (size <= INLINE_CAPACITY)
+		{
+			data_ = nullptr;
+			return inline_.data();
+		}
+
+		if (size <= heap_capacity_)
+			return data_ = heap_.get();
+
+		if (size <= ArgsArena::BLOCK_SIZE)
+		{
+			const std::shared_ptr<ArgsArena>& arena = ArgsArena::this_thread_arena();
+			if (std::byte* block = arena->acquire())
+			{
+				arena_ = arena;
+				return data_ = block;
+			}
+		}
+
+		heap_ = std::make_unique<std::byte[]>(size);
+		heap_capacity_ = size;
+		return data_ = heap_.get();
+	}
+
+	/// <summary>
+	/// Drop the content and return the arena block, if it is taken
+	/// </summary>
+	void clear()
+	{
+		release_block();
+		size_ = 0;
+		data_ = nullptr;
+	}
+
+	const std::byte* data() const { return data_ ? data_ : inline_.data(); }
+	size_t size() const { return size_; }
+
+private:
+	void release_block()
+	{
+		if (arena_)
+		{
+			arena_->release(data_);
+			arena_.reset();
+			data_ = nullptr;
+		}
+	}
+
+	size_t size_ = 0;
+	std::byte* data_ = nullptr;          // inline_ when null
+	std::unique_ptr<std::byte[]> heap_;
+	size_t heap_capacity_ = 0;
+	std::shared_ptr<ArgsArena> arena_;   // owner of data_ block
+	std::array<std::byte, INLINE_CAPACITY> inline_;
+};
+
+namespace internal
+{
+
+template<class T>
+inline size_t packed_size(const T& value)
+{
+	using stored_t = packed_arg_t<T>;
+
+	if constexpr (std::same_as<stored_t, std::string_view>)
+		return sizeof(ArgTag) + sizeof(uint64_t) + std::string_view(value).size();
+	else
+		return sizeof(ArgTag) + sizeof(stored_t);
+}
+
+template<class T>
+inline std::byte* pack_arg(std::byte* out, const T& value)
+{
+	using stored_t = packed_arg_t<T>;
+
+	constexpr ArgTag tag = packed_arg_tag_v<T>;
+	std::memcpy(out, &tag, sizeof(tag));
+	out += sizeof(tag);
+
+	if constexpr (std::same_as<stored_t, std::string_view>)
+	{
+		const std::string_view str = value;
+		const auto size = static_cast<uint64_t>(str.size());
+
+		std::memcpy(out, &size, sizeof(size));
+		out += sizeof(size);
+
+		std::memcpy(out, str.data(), str.size());
+		out += str.size();
+	}
+	else
+	{
+		const auto stored = static_cast<stored_t>(value);
+		std::memcpy(out, &stored, sizeof(stored));
+		out += sizeof(stored);
+	}
+
+	return out;
+}
+
+template<class T>
+inline T unpack_arg(const std::byte*& in)
+{
+	in += sizeof(ArgTag);
+
+	if constexpr (std::same_as<T, std::string_view>)
+	{
+		uint64_t size;
+		std::memcpy(&size, in, sizeof(size));
+		in += sizeof(size);
+
+		const std::string_view result(reinterpret_cast<const char*>(in), static_cast<size_t>(size));
+		in += size;
+
+		return result;
+	}
+	else
+	{
+		T result;
+		std::memcpy(&result, in, sizeof(result));
+		in += sizeof(result);
+
+		return result;
+	}
+}
+
+} // namespace internal
+
+/// <summary>
+/// Copy arguments to the buffer as the sequence of [tag][value] items.
+/// Strings are stored as [tag][uint64_t size][characters].
+/// </summary>
+template<packable_arg... Args>
+inline void pack_args(ArgsBuffer& buffer, const Args&... args)
+{
+	const size_t size = (size_t(0) + ... + internal::packed_size(args));
+
+	std::byte* out = buffer.resize(size);
+	((out = internal::pack_arg(out, args)), ...);
+}
+
+/// <summary>
+/// Append format string with arguments packed by pack_args<Args...> to the output string.
+/// </summary>
+template<packable_arg... Args>
+inline void format_packed_args(std::string& out, std::string_view format, const std::byte* data)
+{
+	// braced initialization guarantees left to right evaluation order
+	std::tuple<packed_arg_t<Args>...> values { internal::unpack_arg<packed_arg_t<Args>>(data)... };
+
+	std::apply([&out, format](const auto&... value)
+	{
+		std::vformat_to(std::back_inserter(out), format, std::make_format_args(value...));
+	}, values);
+}
+
+using format_packed_args_t = void(std::string& out, std::string_view format, const std::byte* data);
+
+/// <summary>
+/// Append format string with arguments packed by pack_args to the output string, when types of arguments
+/// are known only from their tags (e.g. arguments read from a binary log). Replacement fields are formatted
+/// one by one with std::format rules; dynamic width and precision ("{:{}}") are not supported.
+/// </summary>
+/// <exception cref="std::format_error">the format string doesn't match arguments</exception>
+void format_tagged_args(std::string& out, std::string_view format, std::span<const std::byte> args);
+
+} // namespace logger
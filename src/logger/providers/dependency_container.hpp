@@ -6,6 +6,8 @@
 #include <type_traits>
 #include <memory>
 #include <any>
+#include <atomic>
+#include <cstdint>
 
 namespace logger
 {
@@ -20,6 +22,19 @@ public:
 	template<class Interface>
 	static std::shared_ptr<Interface> get();
 
+	/// <summary>
+	/// Get provider through the per-thread cache: no lock, no lookup and no reference counting
+	/// until set/emplace change any provider. Use it on hot paths.
+	/// </summary>
+	/// <returns>pointer that is valid on the calling thread until the next get_cached call for the same interface</returns>
+	template<class Interface>
+	static Interface* get_cached();
+
+	/// <summary>
+	/// Version of the container content. Incremented by every set/emplace call.
+	/// </summary>
+	static uint64_t version() { return version_.load(std::memory_order_acquire); }
+
 	template<class Interface, class Impl>
 		requires std::is_base_of_v<Interface, Impl>
 	static void set(std::shared_ptr<Impl> provider);
@@ -27,6 +42,7 @@ public:
 private:
 	static inline std::unordered_map<std::type_index, std::any> services_ = {};
 	static inline std::mutex mutex_ = {};
+	static inline std::atomic<uint64_t> version_ = 0;
 };
 
 template<class Interface, class Impl, class ...Args>
@@ -35,6 +51,7 @@ inline void DependencyContainer::emplace(Args && ...args)
 {
 	std::scoped_lock lock (mutex_);
 	services_[typeid(Interface)] = std::static_pointer_cast<Interface>(std::make_shared<Impl>(std::forward<Args>(args)...));
+	version_.fetch_add(1, std::memory_order_release);
 }
 
 template<class Interface>
@@ -52,12 +69,33 @@ inline std::shared_ptr<Interface> DependencyContainer::get()
 	}
 }
 
+template<class Interface>
+inline Interface* DependencyContainer::get_cached()
+{
+	struct Cache
+	{
+		std::shared_ptr<Interface> provider;
+		uint64_t version = UINT64_MAX;
+	};
+
+	thread_local Cache cache;
+
+	if (const uint64_t current_version = version(); current_version != cache.version)
+	{
+		cache.provider = get<Interface>();
+		cache.version = current_version;
+	}
+
+	return cache.provider.get();
+}
+
 template<class Interface, class Impl>
 	requires std::is_base_of_v<Interface, Impl>
 inline void DependencyContainer::set(std::shared_ptr<Impl> provider)
 {
 	std::scoped_lock lock(mutex_);
 	services_[typeid(Interface)] = std::static_pointer_cast<Interface>(std::move(provider));
+	version_.fetch_add(1, std::memory_order_release);
 }
 
 } // namespace logger::internal
@@ -1,24 +1,106 @@
 ﻿#include "time_provider.hpp"
 
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <format>
+#include <string_view>
+
+namespace
+{
+
+using namespace std::chrono;
+
+/// <summary>
+/// Formatted time of the last second and timezone offset with its validity range.
+/// Cache is per thread, so it doesn't need any synchronization; the text is kept in a fixed size array,
+/// so the change of the second doesn't allocate memory.
+/// </summary>
+struct TimeCache
+{
+	sys_seconds second = sys_seconds::min();
+
+	sys_seconds offset_begin = sys_seconds::max();
+	sys_seconds offset_end = sys_seconds::min();
+	long long offset_hours = 0;
+
+	std::array<char, logger::TIME_BUFFER_SIZE> text {};
+	size_t size = 0;
+	size_t ms_position = 0;
+};
+
+thread_local TimeCache time_cache_;
+
+void update_time_cache(TimeCache& cache, sys_seconds second)
+{
+	if (second < cache.offset_begin || second >= cache.offset_end)
+	{
+		// time zone database lookup is expensive, so it happens only when offset could change
+		const sys_info info = current_zone()->get_info(second);
+
+		cache.offset_begin = info.begin;
+		cache.offset_end = info.end;
+		cache.offset_hours = duration_cast<minutes>(info.offset).count() / 60;
+	}
+
+	cache.second = second;
+
+	// "YYYY-MM-DD hh:mm:ss.000 UTC+h" takes about half of the array, milliseconds are written over the zeros
+	const auto date = std::format_to_n(cache.text.data(), cache.text.size(), "{:%Y-%m-%d %H:%M:%S}.", second);
+	cache.ms_position = static_cast<size_t>(date.out - cache.text.data());
+
+	const auto rest = std::format_to_n(date.out, cache.text.size() - cache.ms_position, "000 UTC{:+}", cache.offset_hours);
+	cache.size = static_cast<size_t>(rest.out - cache.text.data());
+}
+
+size_t copy_to_buffer(std::string_view str, char* buffer, size_t capacity)
+{
+	const size_t size = std::min(str.size(), capacity);
+	std::copy_n(str.data(), size, buffer);
+
+	return size;
+}
+
+std::string_view format_cached(system_clock::time_point now)
+{
+	TimeCache& cache = time_cache_;
+
+	const sys_seconds second = floor<seconds>(now);
+	if (second != cache.second)
+		update_time_cache(cache, second);
+
+	const auto ms = static_cast<unsigned>(duration_cast<milliseconds>(now - second).count());
+
+	cache.text[cache.ms_position]     = static_cast<char>('0' + ms / 100);
+	cache.text[cache.ms_position + 1] = static_cast<char>('0' + ms / 10 % 10);
+	cache.text[cache.ms_position + 2] = static_cast<char>('0' + ms % 10);
+
+	return { cache.text.data(), cache.size };
+}
+
+} // namespace
 
 namespace logger
 { 
 
-std::string DefaultTimeProvider::now() const
+size_t TimeProvider::format_to(time_point time, char* buffer, size_t capacity) const
 {
-	const auto now = std::chrono::system_clock::now();
-	const auto now_time_t = std::chrono::system_clock::to_time_t(now);
-	const auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
+	return copy_to_buffer(to_string(time), buffer, capacity);
+}
 
-	const auto tz_offset = std::chrono::duration_cast<std::chrono::minutes>(
-		std::chrono::current_zone()->get_info(now).offset
-	).count();
+std::string DefaultTimeProvider::now() const
+{
+	return to_string(timestamp());
+}
 
-	const std::chrono::sys_seconds sys_time = std::chrono::floor<std::chrono::seconds>(now);
+std::string DefaultTimeProvider::to_string(time_point now) const
+{
+	return std::string(format_cached(now));
+}
 
-	return std::format("{:%Y-%m-%d %H:%M:%S}.{:03d} UTC{:+}", sys_time, now_ms.count(), tz_offset / 60);
+size_t DefaultTimeProvider::format_to(time_point time, char* buffer, size_t capacity) const
+{
+	return copy_to_buffer(format_cached(time), buffer, capacity);
 }
 
 std::string MokTimeProvider::now() const
@@ -26,4 +108,9 @@ std::string MokTimeProvider::now() const
     return "mok date and time";
 }
 
+size_t MokTimeProvider::format_to(time_point, char* buffer, size_t capacity) const
+{
+	return copy_to_buffer("mok date and time", buffer, capacity);
+}
+
 }
@@ -1,24 +1,69 @@
 ﻿#pragma once
 
 #include <string>
+#include <chrono>
+#include <cstddef>
+#include <atomic>
 
 namespace logger
 {
 
+/// <summary>
+/// Buffer size that is enough for time strings of all providers of the library
+/// </summary>
+constexpr size_t TIME_BUFFER_SIZE = 64;
+
 struct TimeProvider
 {
+	using time_point = std::chrono::system_clock::time_point;
+
 	virtual ~TimeProvider() = default;
 	virtual std::string now() const = 0;
+
+	/// <summary>
+	/// Current time to be formatted later with to_string (used by deferred formatting)
+	/// </summary>
+	virtual time_point timestamp() const { return std::chrono::system_clock::now(); }
+
+	/// <summary>
+	/// Format time captured by timestamp(). Default implementation ignores time and calls now().
+	/// </summary>
+	virtual std::string to_string(time_point time) const { return now(); }
+
+	/// <summary>
+	/// Write time captured by timestamp() to the buffer without allocations.
+	/// Default implementation copies to_string(time) result.
+	/// </summary>
+	/// <returns>count of written characters; result is truncated if capacity isn't enough and isn't null-terminated</returns>
+	virtual size_t format_to(time_point time, char* buffer, size_t capacity) const;
 };
 
 struct DefaultTimeProvider : TimeProvider
 {
 	std::string now() const override;
+	std::string to_string(time_point time) const override;
+	size_t format_to(time_point time, char* buffer, size_t capacity) const override;
 };
 
 struct MokTimeProvider : TimeProvider
 {
 	std::string now() const override;
+	size_t format_to(time_point time, char* buffer, size_t capacity) const override;
+};
+
+/// <summary>
+/// Provider with manually controlled time (the epoch until it is set), formatted as by DefaultTimeProvider.
+/// Used to test time dependent behavior, e.g. rotation of files.
+/// </summary>
+struct MokClockTimeProvider : DefaultTimeProvider
+{
+	time_point timestamp() const override { return time_point(time_point::duration(time_.load(std::memory_order_acquire))); }
+
+	void set(time_point time) { time_.store(time.time_since_epoch().count(), std::memory_order_release); }
+	void advance(time_point::duration duration) { time_.fetch_add(duration.count(), std::memory_order_acq_rel); }
+
+private:
+	std::atomic<time_point::rep> time_ = 0;
 };
 
 }
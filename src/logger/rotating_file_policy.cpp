@@ -0,0 +1,528 @@
+#include "rotating_file_policy.hpp"
+#include "providers/dependency_container.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <format>
+#include <iostream>
+#include <stdexcept>
+#include <system_error>
+
+#if defined(_WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#define NOGDI
+	#include <windows.h>
+#else
+	#include <cerrno>
+	#include <cstring>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+constexpr std::chrono::milliseconds MIN_RETRY_DELAY { 10 };
+constexpr std::chrono::milliseconds MAX_RETRY_DELAY { 1000 };
+
+} // namespace
+
+namespace logger
+{
+
+/// <summary>
+/// File opened for appending. It can be renamed while it is open (FILE_SHARE_DELETE on Windows).
+/// </summary>
+class RotatingFileLoggerPolicy::File
+{
+public:
+	/// <exception cref="std::runtime_error">file can't be opened</exception>
+	explicit File(const fs::path& path)
+	{
+#if defined(_WIN32)
+		file_ = CreateFileW(path.c_str(), FILE_APPEND_DATA, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+							OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file_ == INVALID_HANDLE_VALUE)
+			throw std::runtime_error(std::format("can't open file \"{}\": error {}", path.string(), GetLastError()));
+#else
+		fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+		if (fd_ < 0)
+			throw std::runtime_error(std::format("can't open file \"{}\": {}", path.string(), std::strerror(errno)));
+#endif
+
+		std::error_code error;
+		const auto size = fs::file_size(path, error);
+		size_ = error ? 0 : static_cast<size_t>(size);
+	}
+
+	~File()
+	{
+#if defined(_WIN32)
+		CloseHandle(file_);
+#else
+		::close(fd_);
+#endif
+	}
+
+	File(const File&) = delete;
+	File& operator=(const File&) = delete;
+
+	/// <summary>
+	/// Size of the file when it was opened
+	/// </summary>
+	size_t size() const { return size_; }
+
+	/// <exception cref="std::runtime_error">write error</exception>
+	void write(const char* data, size_t size) const
+	{
+#if defined(_WIN32)
+		DWORD written = 0;
+		if (!WriteFile(file_, data, static_cast<DWORD>(size), &written, nullptr) || written != size)
+			throw std::runtime_error(std::format("can't write {} bytes to the log file: error {}", size, GetLastError()));
+#else
+		while (size > 0)
+		{
+			const ssize_t result = ::write(fd_, data, size);
+			if (result < 0 && errno == EINTR)
+				continue;
+
+			if (result <= 0)
+				throw std::runtime_error(std::format("can't write {} bytes to the log file: {}", size, result < 0 ? std::strerror(errno) : "no space"));
+
+			data += result;
+			size -= static_cast<size_t>(result);
+		}
+#endif
+	}
+
+private:
+#if defined(_WIN32)
+	HANDLE file_ = INVALID_HANDLE_VALUE;
+#else
+	int fd_ = -1;
+#endif
+	size_t size_ = 0;
+};
+
+std::mutex RotatingFileLoggerPolicy::mutex_;
+std::condition_variable RotatingFileLoggerPolicy::cv_;
+
+fs::path RotatingFileLoggerPolicy::file_path_;
+std::unique_ptr<RotatingFileLoggerPolicy::File> RotatingFileLoggerPolicy::current_;
+size_t RotatingFileLoggerPolicy::current_size_ = 0;
+std::unique_ptr<RotatingFileLoggerPolicy::File> RotatingFileLoggerPolicy::next_;
+std::unique_ptr<RotatingFileLoggerPolicy::File> RotatingFileLoggerPolicy::rotated_;
+
+size_t RotatingFileLoggerPolicy::max_file_size_ = DEFAULT_MAX_FILE_SIZE;
+size_t RotatingFileLoggerPolicy::max_files_ = DEFAULT_MAX_FILES;
+RotationInterval RotatingFileLoggerPolicy::rotation_interval_ = DEFAULT_ROTATION_INTERVAL;
+TimeProvider::time_point RotatingFileLoggerPolicy::next_rollover_ = TimeProvider::time_point::max();
+
+Compression RotatingFileLoggerPolicy::compression_ = DEFAULT_COMPRESSION;
+int RotatingFileLoggerPolicy::compression_level_ = DEFAULT_COMPRESSION_LEVEL;
+size_t RotatingFileLoggerPolicy::compression_threads_ = DEFAULT_COMPRESSION_THREADS;
+FileCompressor RotatingFileLoggerPolicy::compressor_;
+
+std::string RotatingFileLoggerPolicy::buffer_;
+size_t RotatingFileLoggerPolicy::buffer_size_ = DEFAULT_FILE_BUFFER_SIZE;
+std::chrono::milliseconds RotatingFileLoggerPolicy::flush_interval_ = DEFAULT_FLUSH_INTERVAL;
+std::chrono::steady_clock::time_point RotatingFileLoggerPolicy::last_flush_;
+
+std::mutex RotatingFileLoggerPolicy::files_mutex_;
+uint64_t RotatingFileLoggerPolicy::rotations_count_ = 0;
+size_t RotatingFileLoggerPolicy::files_count_ = DEFAULT_MAX_FILES;
+
+bool RotatingFileLoggerPolicy::stop_ = false;
+std::thread RotatingFileLoggerPolicy::background_;
+
+void RotatingFileLoggerPolicy::set_file_path(const fs::path& file_path)
+{
+	release();
+
+	std::scoped_lock lock(mutex_);
+
+	file_path_ = file_path;
+	current_ = std::make_unique<File>(file_path_);
+	current_size_ = current_->size();
+	last_flush_ = std::chrono::steady_clock::now();
+	reset_next_rollover_unlocked();
+	rotations_count_ = 0;
+
+	// the first next file is opened here, so rotation is possible right away; later ones are opened by the background thread
+	try
+	{
+		next_ = std::make_unique<File>(next_path());
+	}
+	catch (const std::exception&)
+	{
+	}
+
+	background_ = std::thread(&RotatingFileLoggerPolicy::background_loop);
+}
+
+fs::path RotatingFileLoggerPolicy::rotated_path(const fs::path& file_path, size_t index)
+{
+	if (index == 0)
+		return file_path;
+
+	fs::path result = file_path;
+	result.replace_filename(file_path.stem().string() + "." + std::to_string(index) + file_path.extension().string());
+
+	return result;
+}
+
+TimeProvider::time_point RotatingFileLoggerPolicy::next_rollover(TimeProvider::time_point time, RotationInterval interval)
+{
+	using namespace std::chrono;
+
+	switch (interval)
+	{
+	case RotationInterval::HOURLY:
+		return floor<hours>(time) + hours(1);
+
+	case RotationInterval::DAILY:
+		return floor<days>(time) + days(1);
+
+	default:
+		return TimeProvider::time_point::max();
+	}
+}
+
+void RotatingFileLoggerPolicy::configure(const LoggerConfig& config)
+{
+	std::scoped_lock lock(mutex_);
+
+	flush_unlocked();
+
+	buffer_size_ = config.file_buffer_size;
+	flush_interval_ = config.flush_interval;
+	buffer_.reserve(buffer_size_);
+
+	max_file_size_ = config.max_file_size;
+	max_files_ = config.max_files;
+
+	rotation_interval_ = config.rotation_interval;
+	reset_next_rollover_unlocked();
+
+	// the level and the count of threads are applied when compression threads are started
+	compression_ = config.compression;
+	compression_level_ = config.compression_level;
+	compression_threads_ = config.compression_threads;
+}
+
+CompressionStats RotatingFileLoggerPolicy::compression_stats()
+{
+	return compressor_.stats();
+}
+
+void RotatingFileLoggerPolicy::release()
+{
+	{
+		std::scoped_lock lock(mutex_);
+
+		flush_unlocked();
+		stop_ = true;
+	}
+
+	cv_.notify_all();
+
+	if (background_.joinable())
+		background_.join();
+
+	compressor_.stop();
+
+	std::scoped_lock lock(mutex_);
+
+	flush_unlocked();
+	current_.reset();
+
+	// the prepared file was never written
+	if (next_)
+	{
+		next_.reset();
+
+		std::error_code error;
+		fs::remove(next_path(), error);
+	}
+
+	stop_ = false;
+}
+
+void RotatingFileLoggerPolicy::write(const std::string_view message)
+{
+	std::scoped_lock lock(mutex_);
+
+	if (!current_)
+		return;
+
+	rotate_on_time_if_needed_unlocked();
+	append_unlocked(message);
+	flush_if_needed_unlocked();
+}
+
+void RotatingFileLoggerPolicy::write_batch(const std::span<const std::string_view> messages)
+{
+	std::scoped_lock lock(mutex_);
+
+	if (!current_)
+		return;
+
+	rotate_on_time_if_needed_unlocked();
+
+	for (const std::string_view message : messages)
+		append_unlocked(message);
+
+	flush_if_needed_unlocked();
+}
+
+void RotatingFileLoggerPolicy::flush()
+{
+	std::scoped_lock lock(mutex_);
+
+	flush_unlocked();
+}
+
+TimeProvider::time_point RotatingFileLoggerPolicy::now()
+{
+	if (const TimeProvider* time_provider = DependencyContainer::get_cached<TimeProvider>())
+		return time_provider->timestamp();
+
+	return std::chrono::system_clock::now();
+}
+
+void RotatingFileLoggerPolicy::reset_next_rollover_unlocked()
+{
+	// the clock isn't read at all without time rotation
+	if (rotation_interval_ == RotationInterval::NONE)
+		next_rollover_ = TimeProvider::time_point::max();
+	else
+		next_rollover_ = next_rollover(now(), rotation_interval_);
+}
+
+void RotatingFileLoggerPolicy::rotate_on_time_if_needed_unlocked()
+{
+	if (next_rollover_ == TimeProvider::time_point::max())
+		return;
+
+	const TimeProvider::time_point time = now();
+	if (time < next_rollover_ || !next_ || stop_)
+		return;
+
+	// an empty file is kept for the next period
+	if (current_size_ > 0)
+		rotate_unlocked();
+
+	next_rollover_ = next_rollover(time, rotation_interval_);
+}
+
+void RotatingFileLoggerPolicy::append_unlocked(const std::string_view message)
+{
+	const size_t size = message.size() + 1;
+
+	// the file isn't rotated while it is empty, so an entry longer than max_file_size is still written
+	if (max_file_size_ > 0 && current_size_ > 0 && current_size_ + size > max_file_size_ && next_ && !stop_)
+		rotate_unlocked();
+
+	buffer_.append(message);
+	buffer_.push_back('\n');
+	current_size_ += size;
+}
+
+void RotatingFileLoggerPolicy::rotate_unlocked()
+{
+	flush_unlocked();
+
+	// closing and renaming are left to the background thread
+	rotated_ = std::move(current_);
+	current_ = std::move(next_);
+	current_size_ = current_->size();
+
+	cv_.notify_all();
+}
+
+void RotatingFileLoggerPolicy::flush_unlocked()
+{
+	if (!buffer_.empty() && current_)
+	{
+		try
+		{
+			current_->write(buffer_.data(), buffer_.size());
+		}
+		catch (const std::exception& e)
+		{
+			std::cerr << "Error: " << e.what() << std::endl;
+		}
+	}
+
+	buffer_.clear();
+	last_flush_ = std::chrono::steady_clock::now();
+}
+
+void RotatingFileLoggerPolicy::flush_if_needed_unlocked()
+{
+	if (buffer_.size() >= buffer_size_)
+	{
+		flush_unlocked();
+		return;
+	}
+
+	if (flush_interval_.count() > 0 && std::chrono::steady_clock::now() - last_flush_ >= flush_interval_)
+		flush_unlocked();
+}
+
+fs::path RotatingFileLoggerPolicy::next_path()
+{
+	fs::path result = file_path_;
+	result.replace_filename(file_path_.stem().string() + ".next" + file_path_.extension().string());
+
+	return result;
+}
+
+fs::path RotatingFileLoggerPolicy::pending_path(uint64_t rotation)
+{
+	fs::path result = file_path_;
+	result.replace_filename(file_path_.stem().string() + ".pending-" + std::to_string(rotation) + file_path_.extension().string());
+
+	return result;
+}
+
+void RotatingFileLoggerPolicy::remove_rotated(const fs::path& path)
+{
+	std::error_code error;
+
+	fs::remove(path, error);
+	fs::remove(FileCompressor::compressed_path(path), error);
+}
+
+void RotatingFileLoggerPolicy::rename_rotated(const fs::path& from, const fs::path& to)
+{
+	std::error_code error;
+
+	// the compressed file is renamed the same way: log.1.log.gz -> log.2.log.gz
+	for (const fs::path& path : { from, FileCompressor::compressed_path(from) })
+	{
+		if (!fs::exists(path, error))
+			continue;
+
+		fs::rename(path, to.string() + path.string().substr(from.string().size()), error);
+		if (error)
+			std::cerr << std::format("Error: can't rename \"{}\": {}", path.string(), error.message()) << std::endl;
+	}
+}
+
+void RotatingFileLoggerPolicy::finish_rotation(std::unique_ptr<File> file, size_t max_files, bool compress)
+{
+	file.reset();
+
+	std::scoped_lock lock(files_mutex_);
+
+	const uint64_t rotation = ++rotations_count_;
+	files_count_ = max_files;
+
+	// log.2.log -> log.3.log, log.1.log -> log.2.log, log.log -> log.1.log, log.next.log -> log.log;
+	// a file being compressed keeps its pending name and takes its place in the sequence when it is compressed,
+	// so renames never wait for compression
+	if (max_files > 1)
+	{
+		remove_rotated(rotated_path(file_path_, max_files - 1));
+
+		for (size_t index = max_files - 1; index > 1; --index)
+			rename_rotated(rotated_path(file_path_, index - 1), rotated_path(file_path_, index));
+
+		if (compress)
+		{
+			rename_rotated(file_path_, pending_path(rotation));
+			compressor_.submit(pending_path(rotation), [rotation](const fs::path&) { place_compressed(rotation); });
+		}
+		else
+		{
+			rename_rotated(file_path_, rotated_path(file_path_, 1));
+		}
+	}
+	else
+	{
+		remove_rotated(file_path_);
+	}
+
+	rename_rotated(next_path(), file_path_);
+}
+
+void RotatingFileLoggerPolicy::place_compressed(uint64_t rotation)
+{
+	std::scoped_lock lock(files_mutex_);
+
+	// the file was rotated once and moved down by every later rotation
+	const uint64_t index = rotations_count_ - rotation + 1;
+	const fs::path source = pending_path(rotation);
+
+	if (index >= files_count_)
+	{
+		remove_rotated(source);
+		return;
+	}
+
+	// the compressed file or the source one, if compression failed
+	rename_rotated(source, rotated_path(file_path_, static_cast<size_t>(index)));
+}
+
+void RotatingFileLoggerPolicy::background_loop()
+{
+	std::unique_lock lock(mutex_);
+	std::chrono::milliseconds retry_delay = MIN_RETRY_DELAY;
+
+	for (;;)
+	{
+		cv_.wait(lock, []() { return stop_ || rotated_ || !next_; });
+
+		// the next file is prepared after the rotation, it has the same name as the current one until the rename
+		if (rotated_)
+		{
+			std::unique_ptr<File> file = std::move(rotated_);
+			const size_t max_files = max_files_;
+			const bool compress = compression_ != Compression::NONE;
+
+			if (compress)
+				compressor_.start(compression_threads_, compression_level_);
+
+			lock.unlock();
+			finish_rotation(std::move(file), max_files, compress);
+			lock.lock();
+
+			continue;
+		}
+
+		if (stop_)
+			return;
+
+		const fs::path path = next_path();
+		lock.unlock();
+
+		std::unique_ptr<File> file;
+		try
+		{
+			file = std::make_unique<File>(path);
+		}
+		catch (const std::exception& e)
+		{
+			std::cerr << "Error: " << e.what() << std::endl;
+		}
+
+		lock.lock();
+
+		if (!file)
+		{
+			// entries go to the current file until the retry succeeds
+			cv_.wait_for(lock, retry_delay, []() { return stop_; });
+			retry_delay = std::min(retry_delay * 2, MAX_RETRY_DELAY);
+			continue;
+		}
+
+		retry_delay = MIN_RETRY_DELAY;
+		next_ = std::move(file);
+	}
+}
+
+} // namespace logger
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "logger_concepts.hpp"
+#include "logger_config.hpp"
+#include "file_compressor.hpp"
+#include "providers/time_provider.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <condition_variable>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace logger
+{
+
+/// <summary>
+/// File policy that rotates the file when its size reaches max_file_size from the configuration
+/// and (or) at the beginning of every hour or day (rotation_interval):
+/// "log.log" is renamed to "log.1.log", "log.1.log" to "log.2.log" and so on, max_files files are kept
+/// (see rotated_path). The background thread opens the next file in advance, so at rollover writers only
+/// swap the file pointer; closing and renaming are done by the background thread too. If the next file isn't
+/// ready yet, entries are written to the current one, and failed creation of the next file is retried with backoff.
+/// Entries are buffered as by DefaultFileLoggerPolicy.
+/// Time of the next rollover is computed in advance from the time of TimeProvider, the same one
+/// the logger writes to entries, so writers only compare two time points; the system clock is used
+/// while no TimeProvider is set.
+/// With compression from the configuration rotated files are compressed by the pool of low priority threads
+/// ("log.1.log" to "log.1.log.gz"). A file is compressed under a pending name ("log.pending-N.log") and moved
+/// to its place in the sequence when it is compressed, so rotations don't wait for compression.
+/// </summary>
+class RotatingFileLoggerPolicy
+{
+public:
+	using concurrent_policy_tag = void;
+
+	/// <summary>
+	/// Start appending to the file
+	/// </summary>
+	/// <exception cref="std::runtime_error">the file can't be opened</exception>
+	static void set_file_path(const std::filesystem::path& file_path);
+
+	/// <summary>
+	/// Path of the rotated file with the specified index, the current file has index 0
+	/// </summary>
+	static std::filesystem::path rotated_path(const std::filesystem::path& file_path, size_t index);
+
+	/// <summary>
+	/// Time of the first hour or day boundary after the time, time_point::max() for RotationInterval::NONE
+	/// </summary>
+	static TimeProvider::time_point next_rollover(TimeProvider::time_point time, RotationInterval interval);
+
+	static void configure(const LoggerConfig& config);
+
+	/// <summary>
+	/// Progress of rotated files compression
+	/// </summary>
+	static CompressionStats compression_stats();
+
+	/// <summary>
+	/// Write buffered entries, finish started rotations and compression and close the file
+	/// </summary>
+	static void release();
+
+	static void write(const std::string_view message);
+	static void write_batch(const std::span<const std::string_view> messages);
+
+	static void flush();
+
+private:
+	class File;
+
+	static TimeProvider::time_point now();
+	static void reset_next_rollover_unlocked();
+	static void rotate_on_time_if_needed_unlocked();
+	static void append_unlocked(const std::string_view message);
+	static void rotate_unlocked();
+	static void flush_unlocked();
+	static void flush_if_needed_unlocked();
+
+	static std::filesystem::path next_path();
+	static std::filesystem::path pending_path(uint64_t rotation);
+	static void remove_rotated(const std::filesystem::path& path);
+	static void rename_rotated(const std::filesystem::path& from, const std::filesystem::path& to);
+	static void finish_rotation(std::unique_ptr<File> file, size_t max_files, bool compress);
+	static void place_compressed(uint64_t rotation);
+	static void background_loop();
+
+	static std::mutex mutex_;
+	static std::condition_variable cv_;
+
+	static std::filesystem::path file_path_;
+	static std::unique_ptr<File> current_;
+	static size_t current_size_;
+	static std::unique_ptr<File> next_;
+	static std::unique_ptr<File> rotated_;
+
+	static size_t max_file_size_;
+	static size_t max_files_;
+	static RotationInterval rotation_interval_;
+	static TimeProvider::time_point next_rollover_;
+
+	static Compression compression_;
+	static int compression_level_;
+	static size_t compression_threads_;
+	static FileCompressor compressor_;
+
+	// renames of rotated files by the background thread and compression threads
+	static std::mutex files_mutex_;
+	static uint64_t rotations_count_;
+	static size_t files_count_;  // max_files of the last rotation
+
+	static std::string buffer_;
+	static size_t buffer_size_;
+	static std::chrono::milliseconds flush_interval_;
+	static std::chrono::steady_clock::time_point last_flush_;
+
+	static bool stop_;
+	static std::thread background_;
+};
+
+static_assert(releasable_policy<RotatingFileLoggerPolicy>);
+static_assert(batch_policy<RotatingFileLoggerPolicy>);
+static_assert(concurrent_policy<RotatingFileLoggerPolicy>);
+static_assert(configurable_policy<RotatingFileLoggerPolicy>);
+static_assert(flushable_policy<RotatingFileLoggerPolicy>);
+
+} // namespace logger
@@ -0,0 +1,115 @@
+#include "thread_info.hpp"
+
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_set>
+
+#if defined(_WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#define NOGDI
+	#include <windows.h>
+#elif defined(__linux__)
+	#include <sys/syscall.h>
+	#include <unistd.h>
+#elif defined(__APPLE__)
+	#include <pthread.h>
+#endif
+
+namespace
+{
+
+// views of interned strings
+struct ThreadInfo
+{
+	std::string_view std_id;
+	std::string_view system_id;
+	std::string_view name;
+};
+
+ThreadInfo& this_thread_info()
+{
+	thread_local ThreadInfo info;
+	return info;
+}
+
+std::string make_std_id()
+{
+	std::stringstream ss;
+	ss << std::this_thread::get_id();
+
+	return ss.str();
+}
+
+std::string make_system_id()
+{
+#if defined(_WIN32)
+	return std::to_string(GetCurrentThreadId());
+#elif defined(__linux__)
+	return std::to_string(static_cast<long>(syscall(SYS_gettid)));
+#elif defined(__APPLE__)
+	uint64_t id = 0;
+	pthread_threadid_np(nullptr, &id);
+	return std::to_string(id);
+#else
+	return make_std_id();
+#endif
+}
+
+// every distinct id and name is stored once and never freed: records of async loggers keep views of them
+// after their threads exit, static loggers could write records until the end of the process
+std::string_view intern(std::string str)
+{
+	static std::mutex mutex;
+	static auto* strings = new std::unordered_set<std::string>();
+
+	std::scoped_lock lock(mutex);
+	return *strings->insert(std::move(str)).first;
+}
+
+} // namespace
+
+namespace logger
+{
+
+ThreadIdType str_to_thread_id_type(const std::string_view type_str)
+{
+	if (type_str == "std")
+		return ThreadIdType::STD;
+
+	if (type_str == "system")
+		return ThreadIdType::SYSTEM;
+
+	throw std::runtime_error("unknown thread id type string");
+}
+
+void set_this_thread_name(const std::string_view name)
+{
+	this_thread_info().name = name.empty() ? std::string_view() : intern(std::string(name));
+}
+
+std::string_view this_thread_id(ThreadIdType type)
+{
+	ThreadInfo& info = this_thread_info();
+
+	if (!info.name.empty())
+		return info.name;
+
+	if (type == ThreadIdType::SYSTEM)
+	{
+		if (info.system_id.empty())
+			info.system_id = intern(make_system_id());
+
+		return info.system_id;
+	}
+
+	if (info.std_id.empty())
+		info.std_id = intern(make_std_id());
+
+	return info.std_id;
+}
+
+} // namespace logger
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace logger
+{
+
+enum class ThreadIdType : uint8_t
+{
+	STD,    // std::thread::id as it is written to std::ostream
+	SYSTEM  // numeric system thread id (gettid() on Linux, GetCurrentThreadId() on Windows)
+};
+
+constexpr ThreadIdType DEFAULT_THREAD_ID_TYPE = ThreadIdType::STD;
+
+/// <summary>
+/// Converting string representation of thread id type ("std" or "system") to logger::ThreadIdType enum value
+/// </summary>
+/// <exception cref="std::runtime_error">string representation is unknown</exception>
+ThreadIdType str_to_thread_id_type(const std::string_view type_str);
+
+/// <summary>
+/// Set the name of the current thread that is written instead of its id.
+/// Empty name restores the id.
+/// </summary>
+void set_this_thread_name(const std::string_view name);
+
+/// <summary>
+/// Id (or name, if it is set) of the current thread. The string is built once per thread and cached.
+/// </summary>
+/// <returns>view of the interned string that is valid until the end of the process, so records could keep it</returns>
+std::string_view this_thread_id(ThreadIdType type = DEFAULT_THREAD_ID_TYPE);
+
+} // namespace logger
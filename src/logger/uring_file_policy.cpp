@@ -0,0 +1,562 @@
+#include "uring_file_policy.hpp"
+
+#if defined(__linux__)
+
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+namespace logger
+{
+
+namespace internal
+{
+
+/// <summary>
+/// Minimal io_uring over raw system calls (no liburing dependency).
+/// Entries are submitted by one thread at a time and completions are reaped by one thread.
+/// The waiting thread polls the ring together with an eventfd, so it can be woken up without a ring entry.
+/// </summary>
+class IoUring
+{
+public:
+	static constexpr __u64 WAKE_UP = ~0ull;
+
+	/// <summary>
+	/// Create the ring, nullptr if io_uring is unavailable
+	/// </summary>
+	static std::unique_ptr<IoUring> create(unsigned entries)
+	{
+		io_uring_params params {};
+
+		const int fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+		if (fd < 0)
+			return nullptr;
+
+		const int wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+		if (wake_fd < 0)
+		{
+			close(fd);
+			return nullptr;
+		}
+
+		std::unique_ptr<IoUring> ring(new IoUring(fd, wake_fd));
+		if (!ring->map(params))
+			return nullptr;
+
+		return ring;
+	}
+
+	~IoUring()
+	{
+		if (sqes_ != nullptr)
+			munmap(sqes_, sqes_size_);
+		if (cq_ring_ != nullptr && cq_ring_ != sq_ring_)
+			munmap(cq_ring_, cq_ring_size_);
+		if (sq_ring_ != nullptr)
+			munmap(sq_ring_, sq_ring_size_);
+
+		close(fd_);
+		close(wake_fd_);
+	}
+
+	IoUring(const IoUring&) = delete;
+	IoUring& operator=(const IoUring&) = delete;
+
+	/// <summary>
+	/// Register buffers, so the kernel doesn't map them on every write. Plain writes are used if it fails
+	/// (e.g. because of RLIMIT_MEMLOCK).
+	/// </summary>
+	void register_buffers(std::span<const iovec> buffers)
+	{
+		registered_ = syscall(__NR_io_uring_register, fd_, IORING_REGISTER_BUFFERS, buffers.data(), buffers.size()) == 0;
+	}
+
+	bool submit_write(int fd, const char* data, size_t size, size_t offset, size_t buffer)
+	{
+		io_uring_sqe entry {};
+		entry.opcode = registered_ ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+		entry.fd = fd;
+		entry.addr = reinterpret_cast<__u64>(data);
+		entry.len = static_cast<__u32>(size);
+		entry.off = offset;
+		entry.buf_index = registered_ ? static_cast<__u16>(buffer) : 0;
+		entry.user_data = buffer;
+
+		return submit(entry);
+	}
+
+	/// <summary>
+	/// Make the waiting thread return from wait_completions: with a WAKE_UP entry or, if the ring refuses it,
+	/// through the eventfd
+	/// </summary>
+	bool wake_up()
+	{
+		io_uring_sqe entry {};
+		entry.opcode = IORING_OP_NOP;
+		entry.user_data = WAKE_UP;
+
+		if (submit(entry))
+			return true;
+
+		const uint64_t value = 1;
+		for (;;)
+		{
+			if (write(wake_fd_, &value, sizeof(value)) == sizeof(value))
+				return true;
+
+			// EAGAIN: the counter is not read yet, so the thread will be woken up anyway
+			if (errno != EINTR)
+				return errno == EAGAIN;
+		}
+	}
+
+	/// <summary>
+	/// Wait for completions and pass all ready ones to handler(user_data, result)
+	/// </summary>
+	template<class Handler>
+	void wait_completions(Handler&& handler)
+	{
+		__u32 head = *cq_head_;
+		__u32 tail = std::atomic_ref(*cq_tail_).load(std::memory_order_acquire);
+
+		if (head == tail)
+		{
+			// the ring is readable when there are completions;
+			// returns on EINTR too: the caller checks its state and waits again
+			pollfd fds[] = { { fd_, POLLIN, 0 }, { wake_fd_, POLLIN, 0 } };
+			(void) poll(fds, 2, -1);
+
+			if (fds[1].revents & POLLIN)
+			{
+				uint64_t value;
+				(void) read(wake_fd_, &value, sizeof(value));
+			}
+
+			tail = std::atomic_ref(*cq_tail_).load(std::memory_order_acquire);
+		}
+
+		for (; head != tail; ++head)
+		{
+			const io_uring_cqe& completion = cqes_[head & cq_mask_];
+			handler(completion.user_data, completion.res);
+		}
+
+		std::atomic_ref(*cq_head_).store(head, std::memory_order_release);
+	}
+
+private:
+	IoUring(int fd, int wake_fd)
+		: fd_(fd)
+		, wake_fd_(wake_fd)
+	{
+	}
+
+	bool map(const io_uring_params& params)
+	{
+		sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(__u32);
+		cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+		const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+		if (single_mmap)
+			sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+
+		sq_ring_ = map_ring(sq_ring_size_, IORING_OFF_SQ_RING);
+		if (sq_ring_ == nullptr)
+			return false;
+
+		cq_ring_ = single_mmap ? sq_ring_ : map_ring(cq_ring_size_, IORING_OFF_CQ_RING);
+		if (cq_ring_ == nullptr)
+			return false;
+
+		sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+		sqes_ = static_cast<io_uring_sqe*>(map_ring(sqes_size_, IORING_OFF_SQES));
+		if (sqes_ == nullptr)
+			return false;
+
+		char* const sq = static_cast<char*>(sq_ring_);
+		sq_head_ = reinterpret_cast<__u32*>(sq + params.sq_off.head);
+		sq_tail_ = reinterpret_cast<__u32*>(sq + params.sq_off.tail);
+		sq_mask_ = *reinterpret_cast<__u32*>(sq + params.sq_off.ring_mask);
+		sq_array_ = reinterpret_cast<__u32*>(sq + params.sq_off.array);
+
+		char* const cq = static_cast<char*>(cq_ring_);
+		cq_head_ = reinterpret_cast<__u32*>(cq + params.cq_off.head);
+		cq_tail_ = reinterpret_cast<__u32*>(cq + params.cq_off.tail);
+		cq_mask_ = *reinterpret_cast<__u32*>(cq + params.cq_off.ring_mask);
+		cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+		return true;
+	}
+
+	void* map_ring(size_t size, off_t offset) const
+	{
+		void* result = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, offset);
+		return result == MAP_FAILED ? nullptr : result;
+	}
+
+	bool submit(const io_uring_sqe& entry)
+	{
+		const __u32 tail = *sq_tail_;
+		const __u32 index = tail & sq_mask_;
+
+		sqes_[index] = entry;
+		sq_array_[index] = index;
+		std::atomic_ref(*sq_tail_).store(tail + 1, std::memory_order_release);
+
+		for (;;)
+		{
+			if (syscall(__NR_io_uring_enter, fd_, 1, 0, 0, nullptr, 0) >= 0)
+				return true;
+
+			if (errno == EINTR)
+				continue;
+
+			// the entry is taken back if the kernel hasn't consumed it, otherwise its completion will come
+			if (std::atomic_ref(*sq_head_).load(std::memory_order_acquire) != tail)
+				return true;
+
+			std::atomic_ref(*sq_tail_).store(tail, std::memory_order_release);
+			return false;
+		}
+	}
+
+	int fd_ = -1;
+	int wake_fd_ = -1;
+	bool registered_ = false;
+
+	void* sq_ring_ = nullptr;
+	void* cq_ring_ = nullptr;
+	size_t sq_ring_size_ = 0;
+	size_t cq_ring_size_ = 0;
+	io_uring_sqe* sqes_ = nullptr;
+	size_t sqes_size_ = 0;
+
+	__u32* sq_head_ = nullptr;
+	__u32* sq_tail_ = nullptr;
+	__u32 sq_mask_ = 0;
+	__u32* sq_array_ = nullptr;
+
+	__u32* cq_head_ = nullptr;
+	__u32* cq_tail_ = nullptr;
+	__u32 cq_mask_ = 0;
+	io_uring_cqe* cqes_ = nullptr;
+};
+
+} // namespace internal
+
+namespace
+{
+
+long long pwrite_all(int fd, const char* data, size_t size, size_t offset)
+{
+	size_t written = 0;
+	while (written < size)
+	{
+		const ssize_t result = pwrite(fd, data + written, size - written, static_cast<off_t>(offset + written));
+		if (result < 0 && errno == EINTR)
+			continue;
+		if (result <= 0)
+			return result < 0 ? -errno : static_cast<long long>(written);
+
+		written += static_cast<size_t>(result);
+	}
+
+	return static_cast<long long>(written);
+}
+
+/// <summary>
+/// Write the part of the buffer the asynchronous write didn't (short write or error)
+/// </summary>
+void finish_write(int fd, const char* data, size_t size, size_t offset, long long result)
+{
+	const size_t done = result < 0 ? 0 : std::min(static_cast<size_t>(result), size);
+	if (done == size)
+		return;
+
+	const long long rest = pwrite_all(fd, data + done, size - done, offset + done);
+	if (rest < 0 || static_cast<size_t>(rest) != size - done)
+		std::cerr << std::format("Error: can't write {} bytes to the log file: {}", size - done, std::strerror(rest < 0 ? static_cast<int>(-rest) : EIO)) << std::endl;
+}
+
+} // namespace
+
+std::mutex UringFileLoggerPolicy::mutex_;
+std::condition_variable UringFileLoggerPolicy::cv_;
+
+int UringFileLoggerPolicy::fd_ = -1;
+size_t UringFileLoggerPolicy::file_offset_ = 0;
+std::unique_ptr<char[]> UringFileLoggerPolicy::memory_;
+std::vector<size_t> UringFileLoggerPolicy::free_buffers_;
+size_t UringFileLoggerPolicy::current_ = UringFileLoggerPolicy::NO_BUFFER;
+size_t UringFileLoggerPolicy::current_size_ = 0;
+size_t UringFileLoggerPolicy::in_flight_ = 0;
+std::vector<UringFileLoggerPolicy::PendingWrite> UringFileLoggerPolicy::submitted_;
+
+std::unique_ptr<internal::IoUring> UringFileLoggerPolicy::ring_;
+std::deque<UringFileLoggerPolicy::PendingWrite> UringFileLoggerPolicy::pwrite_queue_;
+bool UringFileLoggerPolicy::stop_ = false;
+std::thread UringFileLoggerPolicy::thread_;
+
+void UringFileLoggerPolicy::set_file_path(const fs::path& file_path, bool use_io_uring)
+{
+	release();
+
+	std::scoped_lock lock(mutex_);
+
+	const int fd = open(file_path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+	if (fd < 0)
+		throw std::runtime_error(std::format("can't open file \"{}\": {}", file_path.string(), std::strerror(errno)));
+
+	const off_t end = lseek(fd, 0, SEEK_END);
+	fd_ = fd;
+	file_offset_ = end < 0 ? 0 : static_cast<size_t>(end);
+
+	if (!memory_)
+		memory_ = std::make_unique<char[]>(URING_BUFFERS_COUNT * URING_BUFFER_SIZE);
+
+	free_buffers_.clear();
+	for (size_t i = URING_BUFFERS_COUNT; i > 0; --i)
+		free_buffers_.push_back(i - 1);
+
+	submitted_.assign(URING_BUFFERS_COUNT, {});
+
+	// one more entry for the wake-up on release
+	ring_ = use_io_uring ? internal::IoUring::create(URING_BUFFERS_COUNT + 1) : nullptr;
+
+	if (ring_)
+	{
+		std::array<iovec, URING_BUFFERS_COUNT> buffers;
+		for (size_t i = 0; i < URING_BUFFERS_COUNT; ++i)
+			buffers[i] = { memory_.get() + i * URING_BUFFER_SIZE, URING_BUFFER_SIZE };
+
+		ring_->register_buffers(buffers);
+		thread_ = std::thread(&UringFileLoggerPolicy::completion_loop);
+	}
+	else
+	{
+		thread_ = std::thread(&UringFileLoggerPolicy::pwrite_loop);
+	}
+}
+
+bool UringFileLoggerPolicy::uses_io_uring()
+{
+	std::scoped_lock lock(mutex_);
+	return ring_ != nullptr;
+}
+
+void UringFileLoggerPolicy::release()
+{
+	std::unique_lock lock(mutex_);
+
+	if (fd_ < 0)
+		return;
+
+	// writes are not accepted any more: entries written while submitted buffers are drained
+	// would fill a new buffer after the last submit
+	stop_ = true;
+	submit_current_unlocked();
+
+	// writers waiting for a free buffer return, the pwrite thread exits when its queue is empty
+	cv_.notify_all();
+	cv_.wait(lock, []() { return in_flight_ == 0; });
+
+	// the completion thread exits when it sees no writes in flight
+	if (ring_ && !ring_->wake_up())
+		std::cerr << "Error: can't wake up io_uring completion thread: " << std::strerror(errno) << std::endl;
+
+	lock.unlock();
+
+	thread_.join();
+
+	lock.lock();
+
+	ring_.reset();
+	close(fd_);
+	fd_ = -1;
+	current_ = NO_BUFFER;
+	current_size_ = 0;
+	free_buffers_.clear();
+	pwrite_queue_.clear();
+	stop_ = false;
+}
+
+void UringFileLoggerPolicy::write(const std::string_view message)
+{
+	std::unique_lock lock(mutex_);
+	append_unlocked(lock, message);
+}
+
+void UringFileLoggerPolicy::write_batch(const std::span<const std::string_view> messages)
+{
+	std::unique_lock lock(mutex_);
+
+	for (const std::string_view message : messages)
+		append_unlocked(lock, message);
+}
+
+void UringFileLoggerPolicy::flush()
+{
+	std::scoped_lock lock(mutex_);
+	submit_current_unlocked();
+}
+
+void UringFileLoggerPolicy::append_unlocked(std::unique_lock<std::mutex>& lock, const std::string_view message)
+{
+	// an entry is never split between buffers, so entries of different threads don't interleave
+	const std::string_view line = message.substr(0, URING_BUFFER_SIZE - 1);
+	const size_t size = line.size() + 1;
+
+	for (;;)
+	{
+		if (fd_ < 0 || stop_)
+			return;
+
+		if (current_ != NO_BUFFER)
+		{
+			if (current_size_ + size <= URING_BUFFER_SIZE)
+				break;
+
+			submit_current_unlocked();
+		}
+
+		if (free_buffers_.empty())
+		{
+			cv_.wait(lock);
+			continue;
+		}
+
+		current_ = free_buffers_.back();
+		current_size_ = 0;
+		free_buffers_.pop_back();
+	}
+
+	char* out = memory_.get() + current_ * URING_BUFFER_SIZE + current_size_;
+	std::memcpy(out, line.data(), line.size());
+	out[line.size()] = '\n';
+	current_size_ += size;
+
+	if (current_size_ == URING_BUFFER_SIZE)
+		submit_current_unlocked();
+}
+
+void UringFileLoggerPolicy::submit_current_unlocked()
+{
+	if (current_ == NO_BUFFER)
+		return;
+
+	const PendingWrite write { current_, current_size_, file_offset_ };
+	current_ = NO_BUFFER;
+	current_size_ = 0;
+
+	if (write.size == 0)
+	{
+		free_buffers_.push_back(write.buffer);
+		return;
+	}
+
+	file_offset_ += write.size;
+	submitted_[write.buffer] = write;
+	++in_flight_;
+
+	const char* data = memory_.get() + write.buffer * URING_BUFFER_SIZE;
+
+	if (!ring_)
+	{
+		pwrite_queue_.push_back(write);
+		cv_.notify_all();
+	}
+	else if (!ring_->submit_write(fd_, data, write.size, write.offset, write.buffer))
+	{
+		// the ring refused the entry: write synchronously
+		finish_write(fd_, data, write.size, write.offset, 0);
+		free_buffers_.push_back(write.buffer);
+		--in_flight_;
+	}
+}
+
+void UringFileLoggerPolicy::complete_write(const PendingWrite& write, long long result)
+{
+	finish_write(fd_, memory_.get() + write.buffer * URING_BUFFER_SIZE, write.size, write.offset, result);
+
+	{
+		std::scoped_lock lock(mutex_);
+		free_buffers_.push_back(write.buffer);
+		--in_flight_;
+	}
+
+	cv_.notify_all();
+}
+
+void UringFileLoggerPolicy::completion_loop()
+{
+	std::vector<std::pair<PendingWrite, long long>> completed;
+
+	for (;;)
+	{
+		completed.clear();
+
+		// completions are reaped in batches: one wait and one head update for all ready writes
+		ring_->wait_completions([&completed](__u64 user_data, int result)
+		{
+			if (user_data != internal::IoUring::WAKE_UP)
+				completed.emplace_back(PendingWrite { static_cast<size_t>(user_data) }, result);
+		});
+
+		{
+			std::scoped_lock lock(mutex_);
+
+			for (auto& [write, result] : completed)
+				write = submitted_[write.buffer];
+		}
+
+		for (const auto& [write, result] : completed)
+			complete_write(write, result);
+
+		std::scoped_lock lock(mutex_);
+		if (stop_ && in_flight_ == 0)
+			return;
+	}
+}
+
+void UringFileLoggerPolicy::pwrite_loop()
+{
+	std::unique_lock lock(mutex_);
+
+	for (;;)
+	{
+		cv_.wait(lock, []() { return stop_ || !pwrite_queue_.empty(); });
+
+		if (pwrite_queue_.empty())
+			return;
+
+		const PendingWrite write = pwrite_queue_.front();
+		pwrite_queue_.pop_front();
+
+		lock.unlock();
+		complete_write(write, 0);
+		lock.lock();
+	}
+}
+
+} // namespace logger
+
+#endif // __linux__
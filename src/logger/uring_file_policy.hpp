@@ -0,0 +1,104 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include "logger_concepts.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace logger
+{
+
+namespace internal
+{
+class IoUring;
+}
+
+/// <summary>
+/// Linux file policy that writes through io_uring. Entries are copied to one of URING_BUFFERS_COUNT buffers
+/// registered in the ring; a filled buffer is submitted as a write at its file offset and the logging thread
+/// goes on with the next free buffer. The completion thread reaps all ready completions at once and returns
+/// their buffers. When io_uring is unavailable at runtime (old or sandboxed kernel), filled buffers are
+/// handed off to a thread writing them with pwrite. A partially filled buffer is submitted on flush()
+/// (loggers call it after entries of flush_level and higher) and on release().
+/// </summary>
+class UringFileLoggerPolicy
+{
+public:
+	using concurrent_policy_tag = void;
+
+	static constexpr size_t URING_BUFFER_SIZE = 256 * 1024;
+	static constexpr size_t URING_BUFFERS_COUNT = 8;
+
+	/// <summary>
+	/// Start appending to the file. If use_io_uring is false, the pwrite thread is used.
+	/// </summary>
+	/// <exception cref="std::runtime_error">the file can't be opened</exception>
+	static void set_file_path(const std::filesystem::path& file_path, bool use_io_uring = true);
+
+	/// <summary>
+	/// True if writes go through io_uring, false if through the pwrite thread
+	/// </summary>
+	static bool uses_io_uring();
+
+	/// <summary>
+	/// Submit the current buffer, wait for all writes and close the file
+	/// </summary>
+	static void release();
+
+	static void write(const std::string_view message);
+	static void write_batch(const std::span<const std::string_view> messages);
+
+	static void flush();
+
+private:
+	static constexpr size_t NO_BUFFER = static_cast<size_t>(-1);
+
+	struct PendingWrite
+	{
+		size_t buffer = 0;
+		size_t size = 0;
+		size_t offset = 0;
+	};
+
+	static void append_unlocked(std::unique_lock<std::mutex>& lock, const std::string_view message);
+	static void submit_current_unlocked();
+	static void complete_write(const PendingWrite& write, long long result);
+	static void completion_loop();
+	static void pwrite_loop();
+
+	static std::mutex mutex_;
+	static std::condition_variable cv_;
+
+	static int fd_;
+	static size_t file_offset_;
+	static std::unique_ptr<char[]> memory_;
+	static std::vector<size_t> free_buffers_;
+	static size_t current_;
+	static size_t current_size_;
+	static size_t in_flight_;
+	static std::vector<PendingWrite> submitted_; // indexed by buffer
+
+	static std::unique_ptr<internal::IoUring> ring_;
+	static std::deque<PendingWrite> pwrite_queue_;
+	static bool stop_;
+	static std::thread thread_;
+};
+
+static_assert(releasable_policy<UringFileLoggerPolicy>);
+static_assert(batch_policy<UringFileLoggerPolicy>);
+static_assert(concurrent_policy<UringFileLoggerPolicy>);
+static_assert(flushable_policy<UringFileLoggerPolicy>);
+
+} // namespace logger
+
+#endif // __linux__
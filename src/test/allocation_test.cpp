@@ -0,0 +1,147 @@
+#include "logger/logger.hpp"
+#include "logger/log_buffers.hpp"
+#include "logger/providers/time_provider.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+// Counting global allocation functions: the test hook for checking that hot paths don't allocate memory
+
+namespace
+{
+
+std::atomic<size_t> allocations_count = 0;
+
+} // namespace
+
+void* operator new(size_t size)
+{
+	allocations_count.fetch_add(1, std::memory_order_relaxed);
+
+	if (void* ptr = std::malloc(size == 0 ? 1 : size))
+		return ptr;
+
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+	std::free(ptr);
+}
+
+namespace logger_test
+{
+
+struct NullPolicy
+{
+	inline static size_t written = 0;
+
+	static void write(std::string_view)
+	{
+		++written;
+	}
+};
+
+TEST(AllocationTest, SteadyStateLoggingDoesNotAllocate)
+{
+	logger::LoggerConfig config;
+	config.log_pattern = "[{{time}}][{{thread-id}}][{{level}}] {{message}}";
+	config.log_level = logger::Level::INFO;
+
+	logger::Logger<NullPolicy> log(config);
+
+	const std::string long_text(2 * logger::SMALL_MESSAGE_SIZE, 'x');
+
+	auto log_messages = [&log, &long_text](size_t iteration)
+	{
+		log.info("plain message");
+		log.warning("request {} done in {:.3f} ms, status {}", iteration, 1.5, "ok");
+		log.error("long message: {}", long_text);
+		log.debug("filtered {}", long_text);
+	};
+
+	// warm up thread buffers and caches
+	log_messages(0);
+
+	NullPolicy::written = 0;
+	const size_t allocations_before = allocations_count.load();
+
+	for (size_t i = 1; i <= 1000; ++i)
+		log_messages(i);
+
+	EXPECT_EQ(allocations_count.load() - allocations_before, 0);
+	EXPECT_EQ(NullPolicy::written, 3000);
+}
+
+TEST(AllocationTest, TimeCacheUpdateDoesNotAllocate)
+{
+	using namespace std::chrono;
+
+	const logger::DefaultTimeProvider time_provider;
+	const auto start = floor<seconds>(system_clock::now());
+
+	std::array<char, logger::TIME_BUFFER_SIZE> buffer;
+
+	// warm up the cache and the time zone lookup
+	const size_t size = time_provider.format_to(start, buffer.data(), buffer.size());
+
+	const size_t allocations_before = allocations_count.load();
+
+	// every call is in the next second, so the formatted second is updated each time
+	for (int i = 1; i <= 100; ++i)
+		EXPECT_EQ(time_provider.format_to(start + seconds(i) + milliseconds(i), buffer.data(), buffer.size()), size);
+
+	EXPECT_EQ(allocations_count.load() - allocations_before, 0);
+	const std::string_view text(buffer.data(), size);
+	EXPECT_EQ(text.substr(text.find('.') + 1, 3), "100");
+}
+
+TEST(AllocationTest, FormatMessageSmallBuffer)
+{
+	logger::ThreadLogBuffers& buffers = logger::this_thread_log_buffers();
+
+	const std::string_view small = logger::format_message(buffers, "{}-{}", 1, "two");
+	EXPECT_EQ(small, "1-two");
+	EXPECT_EQ(small.data(), buffers.small_message.data());
+
+	const std::string long_text(logger::SMALL_MESSAGE_SIZE, 'y');
+	const std::string_view large = logger::format_message(buffers, "{}!", long_text);
+	EXPECT_EQ(large, long_text + "!");
+	EXPECT_EQ(large.data(), buffers.message.data());
+
+	const std::string_view exact = logger::format_message(buffers, "{}", long_text);
+	EXPECT_EQ(exact, long_text);
+	EXPECT_EQ(exact.data(), buffers.small_message.data());
+
+	const std::string_view larger = logger::format_message(buffers, "{}{}", long_text, long_text);
+	EXPECT_EQ(larger, long_text + long_text);
+	EXPECT_EQ(larger.data(), buffers.message.data());
+}
+
+} // namespace logger_test
@@ -1,12 +1,36 @@
 ﻿#include "logger/logger.hpp"
+#include "logger/async_logger.hpp"
+#include "logger/mpsc_queue.hpp"
+#include "logger/packed_args.hpp"
+#include "logger/logger_macros.hpp"
+#include "logger/thread_info.hpp"
 #include "logger/default_console_policy.hpp"
 #include "logger/default_file_policy.hpp"
+#include "logger/mmap_file_policy.hpp"
+#include "logger/uring_file_policy.hpp"
+#include "logger/direct_file_policy.hpp"
+#include "logger/rotating_file_policy.hpp"
+#include "logger/binary_file_policy.hpp"
+#include "logger/binary_log_reader.hpp"
+#include "logger/binary_log_decoder.hpp"
+#include "logger/gzip_file.hpp"
 #include "logger/logger_config.hpp"
 
 #include <gtest/gtest.h>
 
 #include <fstream>
+#include <sstream>
+#include <iterator>
 #include <filesystem>
+#include <vector>
+#include <span>
+#include <atomic>
+#include <source_location>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
 
 
 
@@ -47,147 +71,1973 @@ TEST(LoggerTest, FileLogging)
 	fs::remove(log_file);
 }
 
+std::string read_whole_file(const std::string& path)
+{
+	std::ifstream file(path);
+	return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+TEST(LoggerTest, FileBufferedLogging)
+{
+	using logger_t = logger::Logger<logger::DefaultFileLoggerPolicy>;
+	const std::string log_file = "test_buffered_log.txt";
+
+	logger::LoggerConfig config;
+	config.log_pattern = "{{message}}";
+	config.file_buffer_size = 1024 * 1024;
+	config.flush_interval = std::chrono::milliseconds(0);
+	config.flush_level = logger::Level::ERROR;
+
+	logger::DefaultFileLoggerPolicy::set_file_path(log_file);
+
+	{
+		logger_t log(config);
+
+		log.info("buffered");
+		EXPECT_EQ(read_whole_file(log_file), "");
+
+		log.error("flushed");
+		EXPECT_EQ(read_whole_file(log_file), "buffered\nflushed\n");
+
+		log.warning("written on release");
+	}
+
+	EXPECT_EQ(read_whole_file(log_file), "buffered\nflushed\nwritten on release\n");
+
+	config.file_buffer_size = 0;
+	logger::DefaultFileLoggerPolicy::set_file_path(log_file);
+
+	{
+		logger_t log(config);
+
+		log.debug("unbuffered");
+		EXPECT_EQ(read_whole_file(log_file), "buffered\nflushed\nwritten on release\nunbuffered\n");
+	}
+
+	fs::remove(log_file);
+}
+
+TEST(LoggerTest, FileFlushByTime)
+{
+	using logger_t = logger::Logger<logger::DefaultFileLoggerPolicy>;
+	const std::string log_file = "test_flush_by_time_log.txt";
+
+	logger::LoggerConfig config;
+	config.log_pattern = "{{message}}";
+	config.file_buffer_size = 1024 * 1024;
+	config.flush_interval = std::chrono::milliseconds(20);
+	config.flush_level = logger::Level::ERROR;
+
+	fs::remove(log_file);
+	logger::DefaultFileLoggerPolicy::set_file_path(log_file);
+
+	{
+		logger_t log(config);
+
+		// the entry is below flush_level and nothing is logged after it: the flusher thread writes it
+		log.info("flushed by time");
+		std::this_thread::sleep_for(config.flush_interval * 10);
+
+		EXPECT_EQ(read_whole_file(log_file), "flushed by time\n");
+	}
+
+	fs::remove(log_file);
+}
+
+TEST(LoggerTest, FileExitWithoutRelease)
+{
+	const std::string log_file = "test_exit_without_release_log.txt";
+
+	// the flusher thread is stopped by static destructors, so the process exits without release()
+	EXPECT_EXIT(
+		{
+			logger::DefaultFileLoggerPolicy::set_file_path(log_file);
+			logger::DefaultFileLoggerPolicy::write("not released");
+			std::exit(0);
+		},
+		::testing::ExitedWithCode(0), "");
+
+	fs::remove(log_file);
+}
+
+TEST(LoggerTest, ConfigParsingFlushStrategy)
+{
+	auto config = logger::read_config_from_json(R"({ "logger" : { "file_buffer_size": 4096, "flush_interval_ms": 250, "flush_level": "warning" } })");
+	EXPECT_EQ(config.file_buffer_size, 4096);
+	EXPECT_EQ(config.flush_interval, std::chrono::milliseconds(250));
+	EXPECT_EQ(config.flush_level, logger::Level::WARNING);
+
+	config = logger::read_config_from_json(R"({ "logger" : { } })");
+	EXPECT_EQ(config.file_buffer_size, logger::DEFAULT_FILE_BUFFER_SIZE);
+	EXPECT_EQ(config.flush_interval, logger::DEFAULT_FLUSH_INTERVAL);
+	EXPECT_EQ(config.flush_level, logger::DEFAULT_FLUSH_LEVEL);
+}
+
+TEST(LoggerTest, MmapFileLogging)
+{
+	using logger_t = logger::Logger<logger::MmapFileLoggerPolicy>;
+
+	constexpr size_t threads_count = 4;
+	constexpr size_t messages_count = 2000;
+
+	const fs::path directory = "test_mmap_logs";
+	const fs::path log_file = directory / "log.log";
+
+	fs::remove_all(directory);
+	fs::create_directory(directory);
+
+	logger::LoggerConfig config;
+	config.log_pattern = "{{message}}";
+	config.mmap_segment_size = 4096; // a lot of segment switches
+
+	{
+		logger_t log(config);
+		logger::MmapFileLoggerPolicy::set_file_path(log_file);
+
+		std::vector<std::thread> threads;
+		for (size_t t = 0; t < threads_count; ++t)
+		{
+			threads.emplace_back([&log, t]()
+			{
+				for (size_t i = 0; i < messages_count; ++i)
+					log.info("{}:{}", t, i);
+			});
+		}
+
+		for (auto& thread : threads)
+			thread.join();
+	}
+
+	std::vector<size_t> next_index(threads_count, 0);
+	size_t segments_count = 0;
+	size_t lines_count = 0;
+
+	for (size_t index = 0; fs::exists(logger::MmapFileLoggerPolicy::segment_path(log_file, index)); ++index)
+	{
+		const fs::path segment = logger::MmapFileLoggerPolicy::segment_path(log_file, index);
+		EXPECT_LE(fs::file_size(segment), config.mmap_segment_size);
+
+		std::ifstream file(segment);
+		for (std::string line; std::getline(file, line); ++lines_count)
+		{
+			const size_t separator = line.find(':');
+			ASSERT_NE(separator, std::string::npos) << line;
+
+			const size_t t = std::stoul(line.substr(0, separator));
+			const size_t i = std::stoul(line.substr(separator + 1));
+			ASSERT_LT(t, threads_count);
+
+			// messages of one thread are written in order
+			EXPECT_EQ(i, next_index[t]++);
+		}
+
+		++segments_count;
+	}
+
+	EXPECT_EQ(lines_count, threads_count * messages_count);
+	EXPECT_GT(segments_count, 1);
+
+	fs::remove_all(directory);
+}
+
+TEST(LoggerTest, MmapFileReleaseWhileWriting)
+{
+	using logger_t = logger::Logger<logger::MmapFileLoggerPolicy>;
+
+	constexpr size_t threads_count = 4;
+
+	const fs::path directory = "test_mmap_release_logs";
+	const fs::path log_file = directory / "log.log";
+
+	fs::remove_all(directory);
+	fs::create_directory(directory);
+
+	logger::LoggerConfig config;
+	config.log_pattern = "{{message}}";
+	config.mmap_segment_size = 4096;
+
+	std::atomic<size_t> written = 0;
+
+	{
+		logger_t log(config);
+		logger::MmapFileLoggerPolicy::set_file_path(log_file);
+
+		std::atomic<bool> stop = false;
+		std::vector<std::thread> threads;
+		for (size_t t = 0; t < threads_count; ++t)
+		{
+			threads.emplace_back([&log, &stop, &written, t]()
+			{
+				for (size_t i = 0; !stop.load(); ++i)
+				{
+					log.info("{}:{}", t, i);
+					written.fetch_add(1);
+				}
+			});
+		}
+
+		// segments are switched and filled while the policy is released
+		while (written.load() < 10000)
+			std::this_thread::yield();
+
+		logger::MmapFileLoggerPolicy::release();
+
+		stop.store(true);
+		for (auto& thread : threads)
+			thread.join();
+	}
+
+	size_t lines_count = 0;
+
+	for (size_t index = 0; fs::exists(logger::MmapFileLoggerPolicy::segment_path(log_file, index)); ++index)
+	{
+		std::ifstream file(logger::MmapFileLoggerPolicy::segment_path(log_file, index));
+		for (std::string line; std::getline(file, line); ++lines_count)
+		{
+			// segments are truncated to committed entries only
+			const size_t separator = line.find(':');
+			ASSERT_NE(separator, std::string::npos) << line;
+			ASSERT_LT(std::stoul(line.substr(0, separator)), threads_count);
+		}
+	}
+
+	EXPECT_GT(lines_count, 0u);
+	EXPECT_LE(lines_count, written.load());
+
+	fs::remove_all(directory);
+}
+
+TEST(LoggerTest, DirectFileLogging)
+{
+	using logger_t = logger::Logger<logger::DirectFileLoggerPolicy>;
+
+	constexpr size_t threads_count = 4;
+	constexpr size_t messages_count = 50000; // several buffers
+
+	const std::string log_file = "test_direct_log.txt";
+	fs::remove(log_file);
+
+	logger::LoggerConfig config;
+	config.log_pattern = "{{message}}";
+	config.flush_level = logger::Level::ERROR;
+
+	{
+		logger_t log(config);
+		logger::DirectFileLoggerPolicy::set_file_path(log_file);
+
+		log.info("buffered");
+		EXPECT_EQ(read_whole_file(log_file), "");
+
+		// the padded block is cut to the real size
+		log.error("flushed");
+		logger::DirectFileLoggerPolicy::flush(); // waits for the previous write
+		EXPECT_EQ(read_whole_file(log_file), "buffered\nflushed\n");
+
+		// the tail block is written again with the new entry
+		log.error("flushed again");
+		logger::DirectFileLoggerPolicy::flush();
+		EXPECT_EQ(read_whole_file(log_file), "buffered\nflushed\nflushed again\n");
+
+		log.info("written on release");
+	}
+
+	EXPECT_EQ(read_whole_file(log_file), "buffered\nflushed\nflushed again\nwritten on release\n");
+
+	{
+		logger_t log(config);
+
+		// appends after the unaligned end of the existing file
+		logger::DirectFileLoggerPolicy::set_file_path(log_file);
+
+		std::vector<std::thread> threads;
+		for (size_t t = 0; t < threads_count; ++t)
+		{
+			threads.emplace_back([&log, t]()
+			{
+				for (size_t i = 0; i < messages_count; ++i)
+					log.info("{}:{}", t, i);
+			});
+		}
+
+		for (auto& thread : threads)
+			thread.join();
+	}
+
+	std::ifstream file(log_file);
+	std::string line;
+
+	for (const std::string_view expected : { "buffered", "flushed", "flushed again", "written on release" })
+	{
+		ASSERT_TRUE(std::getline(file, line));
+		EXPECT_EQ(line, expected);
+	}
+
+	std::vector<size_t> next_index(threads_count, 0);
+	size_t lines_count = 0;
+
+	for (; std::getline(file, line); ++lines_count)
+	{
+		const size_t separator = line.find(':');
+		ASSERT_NE(separator, std::string::npos) << line;
+
+		const size_t t = std::stoul(line.substr(0, separator));
+		const size_t i = std::stoul(line.substr(separator + 1));
+		ASSERT_LT(t, threads_count);
+
+		EXPECT_EQ(i, next_index[t]++);
+	}
+
+	EXPECT_EQ(lines_count, threads_count * messages_count);
+
+	file.close();
+	fs::remove(log_file);
+}
+
+TEST(LoggerTest, RotatingFileLogging)
+{
+	using logger_t = logger::Logger<logger::RotatingFileLoggerPolicy>;
+	using logger::RotatingFileLoggerPolicy;
+
+	constexpr size_t messages_count = 300;
+
+	const fs::path directory = "test_rotating_logs";
+	const fs::path log_file = directory / "log.log";
+
+	fs::remove_all(directory);
+	fs::create_directory(directory);
+
+	logger::LoggerConfig config;
+	config.log_pattern = "{{message}}";
+	config.file_buffer_size = 0;
+	config.max_file_size = 256;
+	config.max_files = 3;
+
+	{
+		logger_t log(config);
+		RotatingFileLoggerPolicy::set_file_path(log_file);
+
+		for (size_t i = 0; i < messages_count; ++i)
+		{
+			log.info("message {:04}", i);
+
+			// gives the background thread time to prepare the next file
+			std::this_thread::sleep_for(std::chrono::microseconds(200));
+		}
+	}
+
+	EXPECT_TRUE(fs::exists(RotatingFileLoggerPolicy::rotated_path(log_file, 1)));
+	EXPECT_FALSE(fs::exists(RotatingFileLoggerPolicy::rotated_path(log_file, config.max_files)));
+
+	size_t files_count = 0;
+	for (const auto& entry : fs::directory_iterator(directory))
+		files_count += entry.is_regular_file() ? 1 : 0;
+
+	EXPECT_EQ(files_count, config.max_files); // the prepared next file is removed on release
+
+	// the oldest file first: entries are consecutive up to the last one
+	std::vector<size_t> indices;
+	for (size_t index = config.max_files; index > 0; --index)
+	{
+		std::ifstream file(RotatingFileLoggerPolicy::rotated_path(log_file, index - 1));
+		for (std::string line; std::getline(file, line); )
+			indices.push_back(std::stoul(line.substr(line.find(' ') + 1)));
+	}
+
+	ASSERT_FALSE(indices.empty());
+	EXPECT_EQ(indices.back(), messages_count - 1);
+
+	for (size_t i = 1; i < indices.size(); ++i)
+		EXPECT_EQ(indices[i], indices[i - 1] + 1);
+
+	fs::remove_all(directory);
+}
+
+TEST(LoggerTest, RotatingFileNextFileRetry)
+{
+	using logger_t = logger::Logger<logger::RotatingFileLoggerPolicy>;
+	using logger::RotatingFileLoggerPolicy;
+
+	const fs::path directory = "test_rotating_retry_logs";
+	const fs::path log_file = directory / "log.log";
+	const fs::path next_file = directory / "log.next.log";
+
+	fs::remove_all(directory);
+	fs::create_directory(directory);
+
+	// the directory in place of the next file makes its creation fail
+	fs::create_directory(next_file);
+
+	logger::LoggerConfig config;
+	config.log_pattern = "{{message}}";
+	config.file_buffer_size = 0;
+	config.max_file_size = 16;
+	config.max_files = 2;
+
+	{
+		logger_t log(config);
+		RotatingFileLoggerPolicy::set_file_path(log_file);
+
+		log.info("first entry");
+		log.info("second entry");
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		EXPECT_FALSE(fs::exists(RotatingFileLoggerPolicy::rotated_path(log_file, 1)));
+
+		fs::remove(next_file);
+
+		// rotation resumes once the next file is created by a retry
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+		while (!fs::exists(RotatingFileLoggerPolicy::rotated_path(log_file, 1)) && std::chrono::steady_clock::now() < deadline)
+		{
+			log.info("retry entry");
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		}
+	}
+
+	EXPECT_TRUE(fs::exists(RotatingFileLoggerPolicy::rotated_path(log_file, 1)));
+
+	const std::string rotated = read_whole_file(RotatingFileLoggerPolicy::rotated_path(log_file, 1).string());
+	EXPECT_EQ(rotated.substr(0, 25), "first entry\nsecond entry\n");
+
+	fs::remove_all(directory);
+}
+
+TEST(LoggerTest, TimeRotatingFileLogging)
+{
+	using namespace std::chrono;
+	using logger_t = logger::Logger<logger::RotatingFileLoggerPolicy>;
+	using logger::RotatingFileLoggerPolicy;
+
+	const fs::path directory = "test_time_rotating_logs";
+	const fs::path log_file = directory / "log.log";
+
+	fs::remove_all(directory);
+	fs::create_directory(directory);
+
+	const auto initial_provider = logger::DependencyContainer::get<logger::TimeProvider>();
+	auto clock = std::make_shared<logger::MokClockTimeProvider>();
+	logger::DependencyContainer::set<logger::TimeProvider>(clock);
+
+	const logger::TimeProvider::time_point day = sys_days(year(2024) / January / 1);
+	EXPECT_EQ(RotatingFileLoggerPolicy::next_rollover(day + 10h + 59min, logger::RotationInterval::HOURLY), day + 11h);
+	EXPECT_EQ(RotatingFileLoggerPolicy::next_rollover(day + 11h, logger::RotationInterval::HOURLY), day + 12h);
+	EXPECT_EQ(RotatingFileLoggerPolicy::next_rollover(day + 23h + 59min, logger::RotationInterval::DAILY), day + 24h);
+	EXPECT_EQ(RotatingFileLoggerPolicy::next_rollover(day, logger::RotationInterval::NONE), logger::TimeProvider::time_point::max());
+
+	logger::LoggerConfig config;
+	config.log_pattern = "{{message}}";
+	config.file_buffer_size = 0;
+	config.max_file_size = 0;
+	config.rotation_interval = logger::RotationInterval::HOURLY;
+
+	clock->set(day + 10h + 59min + 59s);
+
+	{
+		logger_t log(config);
+		RotatingFileLoggerPolicy::set_file_path(log_file);
+
+		log.info("before");
+		clock->advance(500ms);
+		log.info("same hour");
+		clock->advance(1s);
+		log.info("next hour");
+	}
+
+	EXPECT_EQ(read_whole_file(RotatingFileLoggerPolicy::rotated_path(log_file, 1).string()), "before\nsame hour\n");
+	EXPECT_EQ(read_whole_file(log_file.string()), "next hour\n");
+
+	config.rotation_interval = logger::RotationInterval::DAILY;
+	clock->set(day + 23h + 59min + 59s);
+
+	{
+		logger_t log(config);
+		RotatingFileLoggerPolicy::set_file_path(log_file);
+
+		log.info("first day");
+		clock->advance(1h); // hours don't matter any more
+		log.info("second day");
+	}
+
+	// without a TimeProvider the policy reads the system clock for time rotation only
+	logger::DependencyContainer::set<logger::TimeProvider>(std::shared_ptr<logger::TimeProvider>());
+
+	const fs::path no_clock_file = directory / "no_clock.log";
+	for (const logger::RotationInterval interval : { logger::RotationInterval::NONE, logger::RotationInterval::DAILY })
+	{
+		config.rotation_interval = interval;
+		RotatingFileLoggerPolicy::configure(config);
+		RotatingFileLoggerPolicy::set_file_path(no_clock_file);
+		RotatingFileLoggerPolicy::write("no clock");
+		RotatingFileLoggerPolicy::release();
+	}
+
+	EXPECT_EQ(read_whole_file(no_clock_file.string()), "no clock\nno clock\n");
+
+	logger::DependencyContainer::set<logger::TimeProvider>(initial_provider);
+
+	EXPECT_EQ(read_whole_file(RotatingFileLoggerPolicy::rotated_path(log_file, 2).string()), "before\nsame hour\n");
+	EXPECT_EQ(read_whole_file(RotatingFileLoggerPolicy::rotated_path(log_file, 1).string()), "next hour\nfirst day\n");
+	EXPECT_EQ(read_whole_file(log_file.string()), "second day\n");
+
+	fs::remove_all(directory);
+}
+
+TEST(LoggerTest, CompressedRotatingFileLogging)
+{
+	using logger_t = logger::Logger<logger::RotatingFileLoggerPolicy>;
+	using logger::RotatingFileLoggerPolicy;
+	using logger::FileCompressor;
+
+	const fs::path directory = "test_compressed_rotating_logs";
+	const fs::path log_file = directory / "log.log";
+
+	fs::remove_all(directory);
+	fs::create_directory(directory);
+
+	logger::LoggerConfig config;
+	config.log_pattern = "{{message}}";
+	config.file_buffer_size = 0;
+	config.max_file_size = 2048;
+	config.max_files = 4;
+	config.compression = logger::Compression::GZIP;
+	config.compression_threads = 2;
+
+	const size_t messages_count = 500;
+
+	{
+		logger_t log(config);
+		RotatingFileLoggerPolicy::set_file_path(log_file);
+
+		for (size_t i = 0; i < messages_count; ++i)
+		{
+			log.info("message {:04}", i);
+			std::this_thread::sleep_for(std::chrono::microseconds(200));
+		}
+	}
+
+	// rotated files are compressed and removed, the current one is kept as is
+	EXPECT_TRUE(fs::exists(log_file));
+	for (size_t index = 1; index < config.max_files; ++index)
+	{
+		const fs::path rotated = RotatingFileLoggerPolicy::rotated_path(log_file, index);
+		EXPECT_FALSE(fs::exists(rotated));
+		EXPECT_TRUE(fs::exists(FileCompressor::compressed_path(rotated)));
+	}
+
+	EXPECT_FALSE(fs::exists(FileCompressor::compressed_path(RotatingFileLoggerPolicy::rotated_path(log_file, config.max_files))));
+
+	// pending files are placed in the sequence or removed by release
+	size_t files_count = 0;
+	for (const auto& entry : fs::directory_iterator(directory))
+	{
+		EXPECT_EQ(entry.path().string().find("pending"), std::string::npos);
+		++files_count;
+	}
+
+	EXPECT_EQ(files_count, config.max_files);
+
+	// gzip header and the size of the source in the trailer
+	const std::string compressed = read_whole_file(FileCompressor::compressed_path(RotatingFileLoggerPolicy::rotated_path(log_file, 1)).string());
+	ASSERT_GT(compressed.size(), 18u);
+	EXPECT_EQ(compressed.substr(0, 3), std::string("\x1f\x8b\x08", 3));
+
+	uint32_t source_size = 0;
+	for (size_t i = 0; i < 4; ++i)
+		source_size |= static_cast<uint32_t>(static_cast<uint8_t>(compressed[compressed.size() - 4 + i])) << (8 * i);
+
+	EXPECT_GT(source_size, config.max_file_size / 2); // the file is rotated before it exceeds the limit
+	EXPECT_LT(compressed.size(), source_size);
+
+	const logger::CompressionStats stats = RotatingFileLoggerPolicy::compression_stats();
+	EXPECT_EQ(stats.pending, 0u);
+	EXPECT_EQ(stats.failed, 0u);
+	EXPECT_GE(stats.compressed, config.max_files - 1);
+	EXPECT_LT(stats.bytes_out, stats.bytes_in);
+
+	fs::remove_all(directory);
+}
+
+TEST(LoggerTest, GzipEncoder)
+{
+	// "a" repeated: one literal and matches, checked by CRC and size of the trailer
+	const std::string data(100000, 'a');
+
+	logger::GzipEncoder encoder(logger::DEFAULT_COMPRESSION_LEVEL);
+	std::string compressed;
+	encoder.write(std::span<const char>(data.data(), 50000), compressed);
+	encoder.write(std::span<const char>(data.data() + 50000, 50000), compressed);
+	encoder.finish(compressed);
+
+	EXPECT_EQ(encoder.input_size(), data.size());
+	EXPECT_LT(compressed.size(), 1000u);
+	EXPECT_EQ(compressed.substr(compressed.size() - 8), std::string("\x87\xfa\xe2\x1b\xa0\x86\x01\x00", 8));
+
+	// incompressible data goes to stored blocks: a few bytes of headers per block
+	std::string noise(100000, '\0');
+	uint32_t state = 1;
+	for (char& c : noise)
+	{
+		state = state * 1664525u + 1013904223u;
+		c = static_cast<char>(state >> 24);
+	}
+
+	logger::GzipEncoder noise_encoder(logger::MAX_COMPRESSION_LEVEL);
+	std::string noise_compressed;
+	noise_encoder.write(noise, noise_compressed);
+	noise_encoder.finish(noise_compressed);
+
+	EXPECT_LT(noise_compressed.size(), noise.size() + 100);
+
+	// the empty stream: header, the empty final block and the trailer
+	logger::GzipEncoder empty_encoder(logger::MAX_COMPRESSION_LEVEL);
+	std::string empty;
+	empty_encoder.finish(empty);
+
+	EXPECT_EQ(empty, std::string("\x1f\x8b\x08\x00\x00\x00\x00\x00\x00\xff\x03\x00\x00\x00\x00\x00\x00\x00\x00\x00", 20));
+}
+
+TEST(LoggerTest, ConfigParsingRotation)
+{
+	auto config = logger::read_config_from_json(R"({ "logger" : { "max_file_size": 1048576, "max_files": 5 } })");
+	EXPECT_EQ(config.max_file_size, 1048576);
+	EXPECT_EQ(config.max_files, 5);
+
+	config = logger::read_config_from_json(R"({ "logger" : { } })");
+	EXPECT_EQ(config.max_file_size, logger::DEFAULT_MAX_FILE_SIZE);
+	EXPECT_EQ(config.max_files, logger::DEFAULT_MAX_FILES);
+
+	EXPECT_EQ(config.rotation_interval, logger::DEFAULT_ROTATION_INTERVAL);
+
+	config = logger::read_config_from_json(R"({ "logger" : { "rotation_interval": "daily" } })");
+	EXPECT_EQ(config.rotation_interval, logger::RotationInterval::DAILY);
+	EXPECT_EQ(logger::str_to_rotation_interval("hourly"), logger::RotationInterval::HOURLY);
+	EXPECT_THROW(logger::str_to_rotation_interval("weekly"), std::runtime_error);
+
+	EXPECT_EQ(config.compression, logger::DEFAULT_COMPRESSION);
+
+	config = logger::read_config_from_json(R"({ "logger" : { "compression": "gzip", "compression_level": 9, "compression_threads": 3 } })");
+	EXPECT_EQ(config.compression, logger::Compression::GZIP);
+	EXPECT_EQ(config.compression_level, 9);
+	EXPECT_EQ(config.compression_threads, 3);
+	EXPECT_THROW(logger::str_to_compression("zip"), std::runtime_error);
+
+	config.compression_level = 10;
+	EXPECT_FALSE(std::get<0>(logger::validate_config(config)));
+
+	// 2^32 + 5 doesn't wrap to 5
+	config = logger::read_config_from_json(R"({ "logger" : { "compression_level": 4294967301 } })");
+	EXPECT_FALSE(std::get<0>(logger::validate_config(config)));
+
+	config.compression_level = logger::DEFAULT_COMPRESSION_LEVEL;
+	config.compression_threads = 0;
+	EXPECT_FALSE(std::get<0>(logger::validate_config(config)));
+
+	config.compression_threads = logger::DEFAULT_COMPRESSION_THREADS;
+	config.max_files = 0;
+	EXPECT_FALSE(std::get<0>(logger::validate_config(config)));
+}
+
+#if defined(__linux__)
+
+TEST(LoggerTest, UringFileLogging)
+{
+	using logger_t = logger::Logger<logger::UringFileLoggerPolicy>;
+
+	constexpr size_t threads_count = 4;
+	constexpr size_t messages_count = 20000; // several buffers
+
+	const std::string log_file = "test_uring_log.txt";
+
+	logger::LoggerConfig config;
+	config.log_pattern = "{{message}}";
+	config.flush_level = logger::Level::ERROR;
+
+	// io_uring if the kernel allows it, then the pwrite thread
+	for (const bool use_io_uring : { true, false })
+	{
+		fs::remove(log_file);
+
+		{
+			logger_t log(config);
+			logger::UringFileLoggerPolicy::set_file_path(log_file, use_io_uring);
+			if (!use_io_uring)
+				EXPECT_FALSE(logger::UringFileLoggerPolicy::uses_io_uring());
+
+			log.info("buffered");
+			log.error("flushed");
+			logger::UringFileLoggerPolicy::release();
+			EXPECT_EQ(read_whole_file(log_file), "buffered\nflushed\n");
+
+			// appends to the existing file
+			logger::UringFileLoggerPolicy::set_file_path(log_file, use_io_uring);
+
+			std::vector<std::thread> threads;
+			for (size_t t = 0; t < threads_count; ++t)
+			{
+				threads.emplace_back([&log, t]()
+				{
+					for (size_t i = 0; i < messages_count; ++i)
+						log.info("{}:{}", t, i);
+				});
+			}
+
+			for (auto& thread : threads)
+				thread.join();
+		}
+
+		std::ifstream file(log_file);
+		std::string line;
+
+		ASSERT_TRUE(std::getline(file, line));
+		EXPECT_EQ(line, "buffered");
+		ASSERT_TRUE(std::getline(file, line));
+		EXPECT_EQ(line, "flushed");
+
+		std::vector<size_t> next_index(threads_count, 0);
+		size_t lines_count = 0;
+
+		for (; std::getline(file, line); ++lines_count)
+		{
+			const size_t separator = line.find(':');
+			ASSERT_NE(separator, std::string::npos) << line;
+
+			const size_t t = std::stoul(line.substr(0, separator));
+			const size_t i = std::stoul(line.substr(separator + 1));
+			ASSERT_LT(t, threads_count);
+
+			EXPECT_EQ(i, next_index[t]++);
+		}
+
+		EXPECT_EQ(lines_count, threads_count * messages_count);
+	}
+
+	fs::remove(log_file);
+}
+
+TEST(LoggerTest, UringFileReleaseWhileWriting)
+{
+	using logger_t = logger::Logger<logger::UringFileLoggerPolicy>;
+
+	constexpr size_t threads_count = 4;
+
+	const std::string log_file = "test_uring_release_log.txt";
+
+	logger::LoggerConfig config;
+	config.log_pattern = "{{message}}";
+
+	for (const bool use_io_uring : { true, false })
+	{
+		fs::remove(log_file);
+
+		{
+			logger_t log(config);
+			logger::UringFileLoggerPolicy::set_file_path(log_file, use_io_uring);
+
+			std::atomic<bool> stop = false;
+			std::atomic<size_t> written = 0;
+			std::vector<std::thread> threads;
+			for (size_t t = 0; t < threads_count; ++t)
+			{
+				threads.emplace_back([&log, &stop, &written, t]()
+				{
+					for (size_t i = 0; !stop.load(); ++i)
+					{
+						log.info("{}:{}", t, i);
+						written.fetch_add(1);
+					}
+				});
+			}
+
+			// several buffers are in flight while the policy is released
+			while (written.load() < 100000)
+				std::this_thread::yield();
+
+			logger::UringFileLoggerPolicy::release();
+
+			stop.store(true);
+			for (auto& thread : threads)
+				thread.join();
+		}
+
+		// entries accepted before the release are all written, later ones are dropped
+		std::ifstream file(log_file);
+		std::vector<size_t> next_index(threads_count, 0);
+		size_t lines_count = 0;
+
+		for (std::string line; std::getline(file, line); ++lines_count)
+		{
+			const size_t separator = line.find(':');
+			ASSERT_NE(separator, std::string::npos) << line;
+
+			const size_t t = std::stoul(line.substr(0, separator));
+			const size_t i = std::stoul(line.substr(separator + 1));
+			ASSERT_LT(t, threads_count);
+
+			EXPECT_EQ(i, next_index[t]++);
+		}
+
+		EXPECT_GE(lines_count, 100000u);
+	}
+
+	fs::remove(log_file);
+}
+
+#endif
+
 TEST(LoggerTest, LogLevelParsing)
 {
-	EXPECT_EQ(logger::str_to_level("debug"), logger::Level::DEBUG);
-	EXPECT_EQ(logger::str_to_level("info"), logger::Level::INFO);
-	EXPECT_EQ(logger::str_to_level("warning"), logger::Level::WARNING);
-	EXPECT_EQ(logger::str_to_level("error"), logger::Level::ERROR);
+	EXPECT_EQ(logger::str_to_level("debug"), logger::Level::DEBUG);
+	EXPECT_EQ(logger::str_to_level("info"), logger::Level::INFO);
+	EXPECT_EQ(logger::str_to_level("warning"), logger::Level::WARNING);
+	EXPECT_EQ(logger::str_to_level("error"), logger::Level::ERROR);
+
+	EXPECT_EQ(logger::level_to_str(logger::Level::DEBUG), "debug");
+	EXPECT_EQ(logger::level_to_str(logger::Level::INFO), "info");
+	EXPECT_EQ(logger::level_to_str(logger::Level::WARNING), "warning");
+	EXPECT_EQ(logger::level_to_str(logger::Level::ERROR), "error");
+}
+
+TEST(LoggerTest, LogLevelParsingException)
+{
+	EXPECT_THROW(logger::str_to_level("UKNOWN"), std::runtime_error);
+	EXPECT_THROW(logger::level_to_str(static_cast<logger::Level>(42)), std::runtime_error);
+}
+
+TEST(LoggerTest, ConfigParsing)
+{
+	constexpr std::string_view log_file = "log.txt";
+	constexpr std::string_view log_pattern = "[{{level}}][{{time}}][{{thread-id}}] {{message}}";
+
+	constexpr std::string_view json_config = R"(
+	{{
+		"logger" : {{
+			"log_file": "{}",
+			"log_level": "info",
+			"log_pattern": "{}"
+		}}
+	}})";
+
+	std::string json_text = std::format(json_config, log_file, log_pattern);
+
+	auto config = logger::read_config_from_json(json_text);
+
+	EXPECT_EQ(config.log_file_path, log_file);
+	EXPECT_EQ(config.log_level, logger::Level::INFO);
+}
+
+TEST(LoggerTest, ConfigParsingFromFile)
+{
+	constexpr std::string_view log_file = "log.txt";
+	constexpr std::string_view log_pattern = "[{{level}}][{{time}}][{{thread-id}}] {{message}}";
+
+	constexpr std::string_view json_config = R"(
+	{{
+		"logger" : {{
+			"log_file": "{}",
+			"log_level": "info",
+			"log_pattern": "{}"
+		}}
+	}})";
+
+	std::string json_text = std::format(json_config, log_file, log_pattern);
+
+	const char config_path[] = "config_log.json";
+
+	std::ofstream config_file (config_path);
+	config_file << json_text << std::endl;
+	config_file.close();
+
+	auto config = logger::read_config(static_cast<fs::path>(config_path));
+
+	EXPECT_EQ(config.log_file_path, log_file);
+	EXPECT_EQ(config.log_level, logger::Level::INFO);
+	EXPECT_EQ(config.log_pattern, log_pattern);
+	EXPECT_EQ(config.thread_id_type, logger::ThreadIdType::STD);
+
+	fs::remove(config_path);
+}
+
+TEST(LoggerTest, ConfigParsingValidatingSuccess)
+{
+
+	logger::LoggerConfig config;
+	config.log_file_path = "log.txt";
+	config.log_level = logger::Level::INFO;
+	config.log_pattern = "[{{level}}][{{time}}][{{thread-id}}] {{message}}";
+
+	auto result = logger::validate_config(config);
+	EXPECT_TRUE(std::get<0>(result));
+}
+
+TEST(LoggerTest, ConfigParsingValidatingFailure)
+{
+	logger::LoggerConfig config;
+	config.log_file_path = "log.txt";
+	config.log_level = logger::Level::INFO;
+	config.log_pattern = "[{{level}}][{{time}}][{{thread-id}] {{message}}";
+
+	auto result = logger::validate_config(config);
+	EXPECT_FALSE(std::get<0>(result));
+}
+
+TEST(LoggerTest, DependencyContainer)
+{
+	auto mok_time_provider = std::make_shared<logger::MokTimeProvider>();
+	logger::DependencyContainer::set<logger::TimeProvider>(mok_time_provider);
+
+	auto mok_time_provider_ptr = logger::DependencyContainer::get<logger::TimeProvider>();
+
+	EXPECT_EQ(mok_time_provider, mok_time_provider_ptr);
+}
+
+TEST(LoggerTest, DefaultTimeProviderFormat)
+{
+	using namespace std::chrono;
+
+	const logger::DefaultTimeProvider provider;
+
+	auto expected = [](system_clock::time_point time)
+	{
+		const auto ms = duration_cast<milliseconds>(time.time_since_epoch()) % 1000;
+		const auto offset = duration_cast<minutes>(current_zone()->get_info(time).offset).count();
+
+		return std::format("{:%Y-%m-%d %H:%M:%S}.{:03d} UTC{:+}", floor<seconds>(time), ms.count(), offset / 60);
+	};
+
+	const system_clock::time_point base = floor<seconds>(system_clock::now());
+
+	for (const auto delta : { milliseconds(0), milliseconds(7), milliseconds(999), milliseconds(1042), milliseconds(-1), milliseconds(3'600'000 * 24 * 180 + 5) })
+	{
+		const system_clock::time_point time = base + delta;
+		EXPECT_EQ(provider.to_string(time), expected(time));
+	}
+
+	EXPECT_EQ(provider.to_string(base + microseconds(123'999)), expected(base + microseconds(123'999)));
+
+	char buffer[logger::TIME_BUFFER_SIZE];
+	const size_t size = provider.format_to(base, buffer, logger::TIME_BUFFER_SIZE);
+	EXPECT_EQ(std::string_view(buffer, size), expected(base));
+
+	EXPECT_EQ(provider.format_to(base, buffer, 4), 4);
+	EXPECT_EQ(std::string_view(buffer, 4), expected(base).substr(0, 4));
+}
+
+TEST(LoggerTest, TimeProviderFormatTo)
+{
+	struct StringOnlyTimeProvider : logger::TimeProvider
+	{
+		std::string now() const override { return "string only"; }
+	};
+
+	char buffer[logger::TIME_BUFFER_SIZE];
+	const auto time = std::chrono::system_clock::now();
+
+	const size_t size = StringOnlyTimeProvider().format_to(time, buffer, logger::TIME_BUFFER_SIZE);
+	EXPECT_EQ(std::string_view(buffer, size), "string only");
+
+	const size_t mok_size = logger::MokTimeProvider().format_to(time, buffer, logger::TIME_BUFFER_SIZE);
+	EXPECT_EQ(std::string_view(buffer, mok_size), logger::MokTimeProvider().now());
+}
+
+TEST(LoggerTest, DependencyContainerCached)
+{
+	const auto initial_provider = logger::DependencyContainer::get<logger::TimeProvider>();
+	EXPECT_EQ(logger::DependencyContainer::get_cached<logger::TimeProvider>(), initial_provider.get());
+
+	const uint64_t version = logger::DependencyContainer::version();
+
+	auto provider = std::make_shared<logger::DefaultTimeProvider>();
+	logger::DependencyContainer::set<logger::TimeProvider>(provider);
+
+	EXPECT_GT(logger::DependencyContainer::version(), version);
+	EXPECT_EQ(logger::DependencyContainer::get_cached<logger::TimeProvider>(), provider.get());
+
+	logger::TimeProvider* other_thread_provider = nullptr;
+	std::thread([&other_thread_provider]()
+	{
+		other_thread_provider = logger::DependencyContainer::get_cached<logger::TimeProvider>();
+	}).join();
+	EXPECT_EQ(other_thread_provider, provider.get());
+
+	logger::DependencyContainer::set<logger::TimeProvider>(initial_provider);
+	EXPECT_EQ(logger::DependencyContainer::get_cached<logger::TimeProvider>(), initial_provider.get());
+}
+
+struct MokStringPolicy
+{
+	inline static std::string output;
+
+	static void write(std::string_view message)
+	{
+		output = message;
+	}
+};
+
+TEST(LoggerTest, MessageFormatFromConfig)
+{
+	logger::LoggerConfig config;
+	config.log_level = logger::Level::WARNING;
+	config.log_pattern = "[{{time}}][{{level}}] {{message}}";
+
+	std::string_view check_pattern = "[{0}][{2}] {3}";
+	std::string_view message = "some text message";
+
+	std::stringstream ss;
+	ss << std::this_thread::get_id();
+	std::string thread_id = ss.str();
+
+	auto time_provider = logger::DependencyContainer::get<logger::TimeProvider>();
+
+	{
+		auto log = logger::Logger<MokStringPolicy>(config);
+		log.error(message);
+	}
+
+	std::string check_message = std::vformat(check_pattern, std::make_format_args(time_provider->now(),
+														    thread_id,
+														    logger::level_to_str(logger::Level::ERROR),
+														    message));
+
+	EXPECT_EQ(check_message, MokStringPolicy::output);
+}
+
+TEST(LoggerTest, CompileLogPattern)
+{
+	std::string text;
+	std::vector<logger::PatternToken> tokens;
+
+	ASSERT_TRUE(logger::compile_log_pattern("[{{time}}][[{{level}}]] {{unknown}} {{message}}", text, tokens));
+	EXPECT_EQ(text, "[][[]] {unknown} ");
+	ASSERT_EQ(tokens.size(), 6);
+	EXPECT_TRUE(tokens[1].is_field);
+	EXPECT_EQ(tokens[1].field, logger::PatternField::TIME);
+	EXPECT_EQ(tokens[3].field, logger::PatternField::LEVEL);
+	EXPECT_EQ(tokens[5].field, logger::PatternField::MESSAGE);
+	EXPECT_FALSE(tokens[4].is_field);
+	EXPECT_EQ(text.substr(tokens[4].offset, tokens[4].size), "]] {unknown} ");
+
+	EXPECT_FALSE(logger::compile_log_pattern("[{{level}}][{{time}}][{{thread-id}] {{message}}", text, tokens));
+	EXPECT_FALSE(logger::compile_log_pattern("{{message}} }", text, tokens));
+	EXPECT_FALSE(logger::compile_log_pattern("{5}", text, tokens));
+}
+
+TEST(LoggerTest, StaticLogPattern)
+{
+	using pattern_t = logger::StaticLogPattern<"[{{time}}][{{level}}] {{message}} {{level}}">;
+	using logger_t = logger::Logger<pattern_t, MokStringPolicy>;
+
+	static_assert(logger::is_logger<logger_t>);
+	static_assert(logger::logger_has_policy<logger_t, MokStringPolicy>);
+	static_assert(logger::logger_option<pattern_t>);
+	static_assert(!logger::logger_policy<pattern_t>);
+
+	logger::LoggerConfig config;
+	config.log_pattern = "ignored {{message}}";
+
+	logger_t log(config);
+	log.warning("static pattern");
+
+	EXPECT_EQ(MokStringPolicy::output, "[mok date and time][warning] static pattern warning");
+
+	std::string output = "prefix ";
+	pattern_t::format_to(output, { "t", "id", "l", "m" });
+	EXPECT_EQ(output, "prefix [t][l] m l");
+}
+
+TEST(LoggerTest, MpscQueue)
+{
+	logger::MpscQueue<int> queue(3);
+	EXPECT_EQ(queue.capacity(), 4);
+	EXPECT_TRUE(queue.empty());
+
+	for (int i = 0; i < 4; ++i)
+		EXPECT_TRUE(queue.try_push(std::move(i)));
+
+	int value = 42;
+	EXPECT_FALSE(queue.try_push(std::move(value)));
+	EXPECT_EQ(queue.enqueued(), 4);
+
+	for (int i = 0; i < 4; ++i)
+	{
+		ASSERT_TRUE(queue.try_pop(value));
+		EXPECT_EQ(value, i);
+	}
+
+	EXPECT_FALSE(queue.try_pop(value));
+	EXPECT_TRUE(queue.empty());
+}
+
+struct MokCollectPolicy
+{
+	inline static std::vector<std::string> output;
+
+	static void write(std::string_view message)
+	{
+		output.emplace_back(message);
+	}
+};
+
+TEST(LoggerTest, AsyncLogging)
+{
+	constexpr size_t threads_count = 4;
+	constexpr size_t messages_count = 1000;
+
+	logger::LoggerConfig config;
+	config.log_pattern = "{{message}}";
+	config.async_queue_size = 16;
+
+	MokCollectPolicy::output.clear();
+
+	{
+		logger::AsyncLogger<MokCollectPolicy> log(config);
+
+		std::vector<std::thread> threads;
+		for (size_t t = 0; t < threads_count; ++t)
+		{
+			threads.emplace_back([&log, t]()
+			{
+				for (size_t i = 0; i < messages_count; ++i)
+					log.info(std::format("{}:{}", t, i));
+			});
+		}
+
+		for (auto& thread : threads)
+			thread.join();
+
+		log.flush();
+		EXPECT_EQ(MokCollectPolicy::output.size(), threads_count * messages_count);
+
+		log.debug("last message");
+	}
+
+	ASSERT_EQ(MokCollectPolicy::output.size(), threads_count * messages_count + 1);
+	EXPECT_EQ(MokCollectPolicy::output.back(), "last message");
+
+	std::vector<size_t> next_index(threads_count, 0);
+	for (size_t i = 0; i < threads_count * messages_count; ++i)
+	{
+		const std::string& message = MokCollectPolicy::output[i];
+		const size_t separator = message.find(':');
+		const size_t t = std::stoul(message.substr(0, separator));
+		const size_t index = std::stoul(message.substr(separator + 1));
+
+		EXPECT_EQ(index, next_index[t]++);
+	}
+}
+
+struct MokBatchPolicy
+{
+	inline static std::vector<std::string> output;
+	inline static std::vector<size_t> batches;
+	inline static std::atomic<bool> blocked = false;
+
+	static void write(std::string_view message)
+	{
+		write_batch({ &message, 1 });
+	}
+
+	static void write_batch(std::span<const std::string_view> messages)
+	{
+		blocked.wait(true);
+
+		output.insert(output.end(), messages.begin(), messages.end());
+		batches.push_back(messages.size());
+	}
+};
+
+TEST(LoggerTest, AsyncBatchWriting)
+{
+	static_assert(logger::batch_policy<MokBatchPolicy>);
+	static_assert(!logger::batch_policy<MokCollectPolicy>);
+
+	constexpr size_t messages_count = 200;
+
+	logger::LoggerConfig config;
+	config.log_pattern = "{{message}}";
+
+	MokBatchPolicy::output.clear();
+	MokBatchPolicy::batches.clear();
+	MokCollectPolicy::output.clear();
+
+	{
+		logger::AsyncLogger<MokBatchPolicy, MokCollectPolicy> log(config);
+
+		// the writer thread is blocked in the first write, so other messages are accumulated in the queue
+		MokBatchPolicy::blocked = true;
+
+		for (size_t i = 0; i < messages_count; ++i)
+			log.info("{}", i);
+
+		MokBatchPolicy::blocked = false;
+		MokBatchPolicy::blocked.notify_all();
+
+		log.flush();
+	}
+
+	ASSERT_EQ(MokBatchPolicy::output.size(), messages_count);
+	ASSERT_EQ(MokCollectPolicy::output.size(), messages_count);
+
+	for (size_t i = 0; i < messages_count; ++i)
+	{
+		EXPECT_EQ(MokBatchPolicy::output[i], std::to_string(i));
+		EXPECT_EQ(MokCollectPolicy::output[i], std::to_string(i));
+	}
+
+	EXPECT_GE(MokBatchPolicy::batches.size(), 2);
+	EXPECT_EQ(std::ranges::max(MokBatchPolicy::batches), logger::ASYNC_BATCH_SIZE);
+}
+
+struct MokCountPolicy
+{
+	inline static std::atomic<size_t> written = 0;
+
+	static void write(std::string_view)
+	{
+		++written;
+	}
+};
+
+TEST(LoggerTest, AsyncParallelFanOut)
+{
+	using logger_t = logger::AsyncLogger<logger::ParallelFanOut, MokBatchPolicy, MokCountPolicy>;
+
+	static_assert(logger_t::fan_out);
+	static_assert(!logger::AsyncLogger<MokBatchPolicy, MokCountPolicy>::fan_out);
+
+	// less than FAN_OUT_RING_SIZE batches, so the blocked policy can't stop the writer thread
+	constexpr size_t messages_count = 10;
+
+	logger::LoggerConfig config;
+	config.log_pattern = "{{message}}";
+
+	MokBatchPolicy::output.clear();
+	MokBatchPolicy::batches.clear();
+	MokCountPolicy::written = 0;
+
+	{
+		logger_t log(config);
+
+		MokBatchPolicy::blocked = true;
+
+		for (size_t i = 0; i < messages_count; ++i)
+			log.info("{}", i);
+
+		// the second policy gets all messages while the first one is blocked
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+		while (MokCountPolicy::written < messages_count && std::chrono::steady_clock::now() < deadline)
+			std::this_thread::yield();
+
+		EXPECT_EQ(MokCountPolicy::written, messages_count);
+
+		MokBatchPolicy::blocked = false;
+		MokBatchPolicy::blocked.notify_all();
+
+		log.flush();
+
+		ASSERT_EQ(MokBatchPolicy::output.size(), messages_count);
+		for (size_t i = 0; i < messages_count; ++i)
+			EXPECT_EQ(MokBatchPolicy::output[i], std::to_string(i));
+
+		log.error("last");
+	}
+
+	EXPECT_EQ(MokCountPolicy::written, messages_count + 1);
+	ASSERT_EQ(MokBatchPolicy::output.size(), messages_count + 1);
+	EXPECT_EQ(MokBatchPolicy::output.back(), "last");
+}
+
+struct MokRecordPolicy
+{
+	struct Record
+	{
+		logger::TimeProvider::time_point time;
+		std::string thread_id;
+		logger::Level level;
+		std::string message;
+		uint_least32_t line;
+		std::string file_name;
+	};
+
+	inline static std::vector<Record> output;
+
+	static void write(const logger::LogRecord& record)
+	{
+		output.push_back({ record.time, std::string(record.thread_id), record.level, std::string(record.message),
+						   record.location.line(), record.location.file_name() });
+	}
+};
+
+TEST(LoggerTest, RecordPolicy)
+{
+	static_assert(logger::record_policy<MokRecordPolicy>);
+	static_assert(!logger::text_policy<MokRecordPolicy>);
+	static_assert(logger::text_policy<MokCollectPolicy>);
+	static_assert(!logger::Logger<MokRecordPolicy>::formats_text);
+	static_assert(logger::Logger<MokRecordPolicy, MokCollectPolicy>::formats_text);
+
+	logger::LoggerConfig config;
+	config.log_pattern = "[{{level}}] {{message}}";
+
+	MokRecordPolicy::output.clear();
+	MokCollectPolicy::output.clear();
+
+	logger::Logger<MokRecordPolicy, MokCollectPolicy> log(config);
+
+	const auto before = logger::DependencyContainer::get<logger::TimeProvider>()->timestamp();
+	const uint_least32_t line = std::source_location::current().line();
+	log.info("request {} done", 42);
+	log.error("failed");
+
+	ASSERT_EQ(MokRecordPolicy::output.size(), 2);
+	ASSERT_EQ(MokCollectPolicy::output.size(), 2);
+
+	const MokRecordPolicy::Record& record = MokRecordPolicy::output[0];
+	EXPECT_EQ(record.level, logger::Level::INFO);
+	EXPECT_EQ(record.message, "request 42 done");
+	EXPECT_EQ(record.thread_id, logger::this_thread_id());
+	EXPECT_GE(record.time, before);
+	EXPECT_EQ(record.line, line + 1);
+	EXPECT_TRUE(record.file_name.ends_with("logger_test.cpp"));
+
+	EXPECT_EQ(MokRecordPolicy::output[1].level, logger::Level::ERROR);
+	EXPECT_EQ(MokRecordPolicy::output[1].message, "failed");
+	EXPECT_EQ(MokRecordPolicy::output[1].line, line + 2);
+
+	EXPECT_EQ(MokCollectPolicy::output[0], "[info] request 42 done");
+	EXPECT_EQ(MokCollectPolicy::output[1], "[error] failed");
+}
+
+TEST(LoggerTest, AsyncRecordPolicy)
+{
+	logger::LoggerConfig config;
+	config.log_pattern = "{{message}}";
+
+	MokRecordPolicy::output.clear();
+
+	uint_least32_t line = 0;
+
+	{
+		logger::AsyncLogger<MokRecordPolicy> log(config);
+
+		line = std::source_location::current().line();
+		log.warning("value {}", 1.5);
+		log.debug("text");
+	}
 
-	EXPECT_EQ(logger::level_to_str(logger::Level::DEBUG), "debug");
-	EXPECT_EQ(logger::level_to_str(logger::Level::INFO), "info");
-	EXPECT_EQ(logger::level_to_str(logger::Level::WARNING), "warning");
-	EXPECT_EQ(logger::level_to_str(logger::Level::ERROR), "error");
+	ASSERT_EQ(MokRecordPolicy::output.size(), 2);
+	EXPECT_EQ(MokRecordPolicy::output[0].level, logger::Level::WARNING);
+	EXPECT_EQ(MokRecordPolicy::output[0].message, "value 1.5");
+	EXPECT_EQ(MokRecordPolicy::output[0].line, line + 1);
+	EXPECT_EQ(MokRecordPolicy::output[1].message, "text");
+	EXPECT_EQ(MokRecordPolicy::output[1].line, line + 2);
 }
 
-TEST(LoggerTest, LogLevelParsingException)
+struct MokSerialPolicy
 {
-	EXPECT_THROW(logger::str_to_level("UKNOWN"), std::runtime_error);
-	EXPECT_THROW(logger::level_to_str(static_cast<logger::Level>(42)), std::runtime_error);
+	inline static std::atomic<size_t> in_write = 0;
+	inline static std::atomic<size_t> max_in_write = 0;
+	inline static std::atomic<size_t> written = 0;
+
+	static void write(std::string_view)
+	{
+		const size_t current = ++in_write;
+
+		size_t max = max_in_write.load();
+		while (current > max && !max_in_write.compare_exchange_weak(max, current))
+			;
+
+		std::this_thread::yield();
+
+		++written;
+		--in_write;
+	}
+};
+
+struct MokConcurrentPolicy
+{
+	using concurrent_policy_tag = void;
+
+	inline static std::atomic<size_t> in_write = 0;
+	inline static std::atomic<bool> overlapped = false;
+
+	static void write(std::string_view)
+	{
+		++in_write;
+
+		// wait until the other thread enters too: that never happens if calls are serialized
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+		while (in_write.load() < 2 && std::chrono::steady_clock::now() < deadline)
+			std::this_thread::yield();
+
+		if (in_write.load() >= 2)
+			overlapped = true;
+	}
+};
+
+TEST(LoggerTest, ConcurrentPolicy)
+{
+	static_assert(logger::concurrent_policy<MokConcurrentPolicy>);
+	static_assert(!logger::concurrent_policy<MokSerialPolicy>);
+	static_assert(logger::concurrent_policy<logger::DefaultFileLoggerPolicy>);
+
+	constexpr size_t threads_count = 4;
+	constexpr size_t messages_count = 1000;
+
+	MokConcurrentPolicy::in_write = 0;
+	MokConcurrentPolicy::overlapped = false;
+
+	{
+		logger::Logger<MokConcurrentPolicy> log;
+
+		std::thread other([&log]() { log.error("other thread"); });
+		log.error("this thread");
+		other.join();
+	}
+
+	EXPECT_TRUE(MokConcurrentPolicy::overlapped);
+
+	MokSerialPolicy::max_in_write = 0;
+	MokSerialPolicy::written = 0;
+
+	{
+		logger::Logger<MokSerialPolicy> log;
+
+		std::vector<std::thread> threads;
+		for (size_t t = 0; t < threads_count; ++t)
+		{
+			threads.emplace_back([&log]()
+			{
+				for (size_t i = 0; i < messages_count; ++i)
+					log.error("message {}", i);
+			});
+		}
+
+		for (auto& thread : threads)
+			thread.join();
+	}
+
+	EXPECT_EQ(MokSerialPolicy::written, threads_count * messages_count);
+	EXPECT_EQ(MokSerialPolicy::max_in_write, 1);
 }
 
-TEST(LoggerTest, ConfigParsing)
+TEST(LoggerTest, PackedArgs)
 {
-	constexpr std::string_view log_file = "log.txt";
-	constexpr std::string_view log_pattern = "[{{level}}][{{time}}][{{thread-id}}] {{message}}";
+	static_assert(logger::packable_arg<int>);
+	static_assert(logger::packable_arg<const char(&)[4]>);
+	static_assert(logger::packable_arg<std::string&>);
+	static_assert(!logger::packable_arg<std::vector<int>>);
+	static_assert(!logger::packable_arg<long double>);
+	static_assert(logger::packed_arg_tag_v<char> == logger::ArgTag::CHAR);
+	static_assert(logger::packed_arg_tag_v<unsigned short> == logger::ArgTag::UINT);
+	static_assert(logger::packed_arg_tag_v<const char*> == logger::ArgTag::STRING);
 
-	constexpr std::string_view json_config = R"(
-	{{
-		"logger" : {{
-			"log_file": "{}",
-			"log_level": "info",
-			"log_pattern": "{}"
-		}}
-	}})";
+	std::string text(logger::ArgsBuffer::INLINE_CAPACITY, 'x');
+	int value = -5;
 
-	std::string json_text = std::format(json_config, log_file, log_pattern);
+	logger::ArgsBuffer buffer;
+	logger::pack_args(buffer, value, 2.5f, true, 'c', "literal", text, &value);
 
-	auto config = logger::read_config_from_json(json_text);
+	std::string output;
+	logger::format_packed_args<int, float, bool, char, const char*, std::string, int*>(output, "{} {} {} {} {} {} {}", buffer.data());
 
-	EXPECT_EQ(config.log_file_path, log_file);
-	EXPECT_EQ(config.log_level, logger::Level::INFO);
+	EXPECT_EQ(output, std::format("{} {} {} {} {} {} {}", value, 2.5f, true, 'c', "literal", text, static_cast<void*>(&value)));
+
+	logger::ArgsBuffer moved = std::move(buffer);
+	output.clear();
+	logger::format_packed_args<int>(output, "{:+05}", moved.data());
+	EXPECT_EQ(output, "-0005");
 }
 
-TEST(LoggerTest, ConfigParsingFromFile)
+TEST(LoggerTest, ArgsArena)
 {
-	constexpr std::string_view log_file = "log.txt";
-	constexpr std::string_view log_pattern = "[{{level}}][{{time}}][{{thread-id}}] {{message}}";
+	logger::ArgsArena arena;
 
-	constexpr std::string_view json_config = R"(
-	{{
-		"logger" : {{
-			"log_file": "{}",
-			"log_level": "info",
-			"log_pattern": "{}"
-		}}
-	}})";
+	std::vector<std::byte*> blocks;
+	while (std::byte* block = arena.acquire())
+		blocks.push_back(block);
 
-	std::string json_text = std::format(json_config, log_file, log_pattern);
+	EXPECT_EQ(blocks.size(), logger::ArgsArena::BLOCK_COUNT);
 
-	const char config_path[] = "config_log.json";
+	arena.release(blocks[5]);
+	EXPECT_EQ(arena.acquire(), blocks[5]);
 
-	std::ofstream config_file (config_path);
-	config_file << json_text << std::endl;
-	config_file.close();
+	for (std::byte* block : blocks)
+		arena.release(block);
 
-	auto config = logger::read_config(static_cast<fs::path>(config_path));
+	// a long pack takes a block of the thread arena and returns it, moved records keep it
+	const std::string text(logger::ArgsBuffer::INLINE_CAPACITY, 'x');
+	const std::shared_ptr<logger::ArgsArena>& thread_arena = logger::ArgsArena::this_thread_arena();
 
-	EXPECT_EQ(config.log_file_path, log_file);
-	EXPECT_EQ(config.log_level, logger::Level::INFO);
-	EXPECT_EQ(config.log_pattern, log_pattern);
+	logger::ArgsBuffer buffer;
+	logger::pack_args(buffer, text);
+	const std::byte* block = buffer.data();
 
-	fs::remove(config_path);
+	logger::ArgsBuffer moved = std::move(buffer);
+	EXPECT_EQ(moved.data(), block);
+	EXPECT_EQ(thread_arena.use_count(), 2);
+
+	std::string output;
+	logger::format_packed_args<std::string>(output, "{}", moved.data());
+	EXPECT_EQ(output, text);
+
+	moved.clear();
+	EXPECT_EQ(thread_arena.use_count(), 1);
+
+	// packs larger than a block reuse the heap buffer
+	const std::string long_text(logger::ArgsArena::BLOCK_SIZE, 'y');
+	logger::pack_args(moved, long_text);
+	const std::byte* heap = moved.data();
+	logger::pack_args(moved, long_text.substr(1));
+	EXPECT_EQ(moved.data(), heap);
 }
 
-TEST(LoggerTest, ConfigParsingValidatingSuccess)
+struct NotPackable
 {
+	int value;
 
+	inline static size_t format_calls = 0;
+};
+
+} // namespace logger_test
+
+template<>
+struct std::formatter<logger_test::NotPackable> : std::formatter<int>
+{
+	auto format(const logger_test::NotPackable& item, std::format_context& ctx) const
+	{
+		++logger_test::NotPackable::format_calls;
+		return std::formatter<int>::format(item.value, ctx);
+	}
+};
+
+namespace logger_test
+{
+
+TEST(LoggerTest, AsyncDeferredFormatting)
+{
 	logger::LoggerConfig config;
-	config.log_file_path = "log.txt";
+	config.log_pattern = "[{{level}}] {{message}}";
 	config.log_level = logger::Level::INFO;
-	config.log_pattern = "[{{level}}][{{time}}][{{thread-id}}] {{message}}";
 
-	auto result = logger::validate_config(config);
-	EXPECT_TRUE(std::get<0>(result));
+	MokCollectPolicy::output.clear();
+
+	{
+		logger::AsyncLogger<MokCollectPolicy> log(config);
+
+		std::string temporary = "temporary string";
+		log.info("{} | {:.2f} | {:>4} | {}", temporary, 3.14159, 42u, NotPackable{ 7 });
+		temporary = "changed";
+
+		log.debug("filtered {}", 1);
+		log.error("{}", "error");
+
+		// long double isn't packed, so digits beyond double precision are kept
+		log.info("{:.20f}", 1.0L / 3);
+	}
+
+	ASSERT_EQ(MokCollectPolicy::output.size(), 3);
+	EXPECT_EQ(MokCollectPolicy::output[0], "[info] temporary string | 3.14 |   42 | 7");
+	EXPECT_EQ(MokCollectPolicy::output[1], "[error] error");
+	EXPECT_EQ(MokCollectPolicy::output[2], std::format("[info] {:.20f}", 1.0L / 3));
 }
 
-TEST(LoggerTest, ConfigParsingValidatingFailure)
+TEST(LoggerTest, FormatTaggedArgs)
 {
-	logger::LoggerConfig config;
-	config.log_file_path = "log.txt";
-	config.log_level = logger::Level::INFO;
-	config.log_pattern = "[{{level}}][{{time}}][{{thread-id}] {{message}}";
+	logger::ArgsBuffer buffer;
+	logger::pack_args(buffer, 42, 3.14159, "text", true, 'c', 7u);
 
-	auto result = logger::validate_config(config);
-	EXPECT_FALSE(std::get<0>(result));
+	std::string output;
+	logger::format_tagged_args(output, "{{{}}} {:.2f} {:>6} {} {} {:#x} {0}", { buffer.data(), buffer.size() });
+	EXPECT_EQ(output, "{42} 3.14   text true c 0x7 42");
+
+	output.clear();
+	EXPECT_THROW(logger::format_tagged_args(output, "{} {} {} {} {} {} {}", { buffer.data(), buffer.size() }), std::format_error);
+	EXPECT_THROW(logger::format_tagged_args(output, "{:{}}", { buffer.data(), buffer.size() }), std::format_error);
+
+	// the size of a string is 64-bit, a corrupted one can't run past the arguments
+	logger::pack_args(buffer, "text");
+	std::vector<std::byte> corrupted(buffer.data(), buffer.data() + buffer.size());
+	const uint64_t huge_size = ~uint64_t(0) - 4;
+	std::memcpy(corrupted.data() + sizeof(logger::ArgTag), &huge_size, sizeof(huge_size));
+
+	EXPECT_THROW(logger::format_tagged_args(output, "{}", corrupted), std::format_error);
 }
 
-TEST(LoggerTest, DependencyContainer)
+struct BinaryLogContent
 {
-	auto mok_time_provider = std::make_shared<logger::MokTimeProvider>();
-	logger::DependencyContainer::set<logger::TimeProvider>(mok_time_provider);
+	std::vector<std::string> messages;
+	std::vector<std::string> threads;
+	std::vector<logger::Level> levels;
+	size_t blocks = 0;
+	size_t sessions = 0;
+};
 
-	auto mok_time_provider_ptr = logger::DependencyContainer::get<logger::TimeProvider>();
+BinaryLogContent read_binary_log(const fs::path& file_path)
+{
+	BinaryLogContent content;
+	std::vector<logger::BinaryLogDictionary> dictionaries;
 
-	EXPECT_EQ(mok_time_provider, mok_time_provider_ptr);
+	std::ifstream file(file_path, std::ios::binary);
+	std::string payload;
+
+	for (const logger::BinaryLogBlock& block : logger::read_binary_log_blocks(file_path))
+	{
+		if (block.session >= dictionaries.size())
+			dictionaries.resize(block.session + 1);
+
+		std::vector<logger::BinaryLogRecord> records;
+		logger::read_binary_block_payload(file, block, payload);
+		logger::parse_binary_block(payload, block.header, dictionaries[block.session], records);
+
+		EXPECT_EQ(records.size(), block.header.records_count);
+
+		for (const logger::BinaryLogRecord& record : records)
+		{
+			std::string message;
+			logger::format_binary_record(message, record, dictionaries[block.session]);
+
+			content.messages.push_back(message);
+			content.threads.push_back(dictionaries[block.session].threads.at(record.thread_index));
+			content.levels.push_back(record.level);
+		}
+
+		++content.blocks;
+	}
+
+	content.sessions = dictionaries.size();
+	return content;
 }
 
-struct MokStringPolicy
+TEST(LoggerTest, BinaryFileLogging)
 {
-	inline static std::string output;
+	using logger::BinaryFileLoggerPolicy;
+
+	static_assert(!logger::Logger<BinaryFileLoggerPolicy>::formats_messages);
+	static_assert(logger::Logger<BinaryFileLoggerPolicy, MokCollectPolicy>::formats_messages);
+
+	const fs::path log_file = "test_binary_log.bin";
+	fs::remove(log_file);
+
+	logger::LoggerConfig config;
+	config.file_buffer_size = 256;
+
+	const size_t messages_count = 100;
 
-	static void write(std::string_view message)
 	{
-		output = message;
+		logger::Logger<BinaryFileLoggerPolicy> log(config);
+		BinaryFileLoggerPolicy::set_file_path(log_file);
+
+		log.info("plain message");
+
+		for (size_t i = 0; i < messages_count; ++i)
+			log.warning("value {} of {:.1f} from \"{}\"", i, 2.5, "sync");
+
+		log.error("not packable {}", NotPackable{ 7 });
 	}
-};
 
-TEST(LoggerTest, MessageFormatFromConfig)
+	// appended to the same file with new dictionaries
+	{
+		logger::AsyncLogger<BinaryFileLoggerPolicy> log(config);
+		BinaryFileLoggerPolicy::set_file_path(log_file);
+
+		std::thread thread([&log]() { log.info("{} from other thread", "async"); });
+		thread.join();
+
+		log.debug("value {} of {:.1f} from \"{}\"", 1, 2.5, "async");
+	}
+
+	const BinaryLogContent content = read_binary_log(log_file);
+
+	ASSERT_EQ(content.messages.size(), messages_count + 4);
+	EXPECT_GT(content.blocks, 2u);
+	EXPECT_EQ(content.sessions, 2u);
+
+	EXPECT_EQ(content.messages[0], "plain message");
+	EXPECT_EQ(content.levels[0], logger::Level::INFO);
+	EXPECT_EQ(content.messages[1], "value 0 of 2.5 from \"sync\"");
+	EXPECT_EQ(content.messages[messages_count], std::format("value {} of 2.5 from \"sync\"", messages_count - 1));
+	EXPECT_EQ(content.levels[messages_count], logger::Level::WARNING);
+	EXPECT_EQ(content.messages[messages_count + 1], "not packable 7");
+	EXPECT_EQ(content.messages[messages_count + 2], "async from other thread");
+	EXPECT_EQ(content.messages[messages_count + 3], "value 1 of 2.5 from \"async\"");
+	EXPECT_EQ(content.levels[messages_count + 3], logger::Level::DEBUG);
+
+	EXPECT_EQ(content.threads[0], content.threads[messages_count]);
+	EXPECT_NE(content.threads[messages_count + 2], content.threads[messages_count + 3]);
+
+	// format strings and thread ids are written once per session: a record is its packed arguments
+	// (27 bytes here) and a few bytes of time delta and ids
+	EXPECT_LT(fs::file_size(log_file), messages_count * 48);
+
+	fs::remove(log_file);
+}
+
+TEST(LoggerTest, BinaryLogDecoding)
+{
+	using namespace std::chrono;
+	using logger::BinaryFileLoggerPolicy;
+
+	const fs::path log_file = "test_binary_decoding.bin";
+	fs::remove(log_file);
+
+	const auto initial_provider = logger::DependencyContainer::get<logger::TimeProvider>();
+	auto clock = std::make_shared<logger::MokClockTimeProvider>();
+	logger::DependencyContainer::set<logger::TimeProvider>(clock);
+
+	const logger::TimeProvider::time_point start = sys_days(year(2024) / January / 1);
+
+	logger::LoggerConfig config;
+	config.file_buffer_size = 128; // many blocks
+	config.flush_interval = milliseconds(0);
+
+	const size_t messages_count = 1000;
+	clock->set(start);
+
+	// two sessions: dictionaries of the second one start anew
+	for (const std::string_view session : { "first", "second" })
+	{
+		logger::Logger<BinaryFileLoggerPolicy> log(config);
+		BinaryFileLoggerPolicy::set_file_path(log_file);
+
+		for (size_t i = 0; i < messages_count / 2; ++i)
+		{
+			const logger::Level level = i % 2 == 0 ? logger::Level::DEBUG : logger::Level::WARNING;
+
+			log.log(level, "{} message {}", session, i);
+			clock->advance(1s);
+		}
+	}
+
+	logger::DependencyContainer::set<logger::TimeProvider>(initial_provider);
+
+	logger::BinaryLogDecodeOptions options;
+	options.log_pattern = "[{{level}}] {{message}}";
+
+	auto decode = [&log_file](const logger::BinaryLogDecodeOptions& options, logger::BinaryLogDecodeStats& stats)
+	{
+		std::ostringstream out;
+		stats = logger::decode_binary_log(log_file, options, out);
+
+		return out.str();
+	};
+
+	logger::BinaryLogDecodeStats stats;
+	const std::string sequential = decode(options, stats);
+
+	EXPECT_EQ(stats.records, messages_count);
+	EXPECT_EQ(stats.written, messages_count);
+	EXPECT_EQ(stats.errors, 0u);
+	EXPECT_GT(stats.blocks, 100u);
+	EXPECT_TRUE(sequential.starts_with("[debug] first message 0\n[warning] first message 1\n"));
+	EXPECT_TRUE(sequential.ends_with(std::format("[warning] second message {}\n", messages_count / 2 - 1)));
+
+	// parallel decoding keeps the order
+	options.threads = 4;
+	EXPECT_EQ(decode(options, stats), sequential);
+
+	// filters: warnings of 10 seconds of the second session
+	options.min_level = logger::Level::WARNING;
+	options.from = start + seconds(messages_count / 2 + 10);
+	options.to = start + seconds(messages_count / 2 + 20);
+
+	const std::string filtered = decode(options, stats);
+
+	EXPECT_EQ(stats.written, 5u);
+	EXPECT_GT(stats.skipped_blocks, stats.blocks / 2);
+	EXPECT_TRUE(filtered.starts_with("[warning] second message 11\n"));
+	EXPECT_TRUE(filtered.ends_with("[warning] second message 19\n"));
+
+	options.log_pattern = "{{message}} {bad}";
+	EXPECT_THROW(decode(options, stats), std::invalid_argument);
+
+	// a corrupted level is rendered as "?" and counted, the decoding goes on
+	fs::remove(log_file);
+
+	{
+		logger::Logger<BinaryFileLoggerPolicy> log(config);
+		BinaryFileLoggerPolicy::set_file_path(log_file);
+
+		log.info("corrupted level");
+		log.error("valid level");
+	}
+
+	// the first record follows the dictionary entries of its format string and thread id
+	std::string content = read_whole_file(log_file.string());
+	const size_t thread_id_position = content.find(logger::this_thread_id());
+	ASSERT_NE(thread_id_position, std::string::npos);
+
+	const size_t level_position = thread_id_position + logger::this_thread_id().size() + 1;
+	ASSERT_EQ(content[level_position], static_cast<char>(logger::Level::INFO));
+	content[level_position] = 0x7f;
+
+	std::ofstream(log_file, std::ios::binary | std::ios::trunc).write(content.data(), static_cast<std::streamsize>(content.size()));
+
+	options = logger::BinaryLogDecodeOptions();
+	options.log_pattern = "[{{level}}] {{message}}";
+
+	EXPECT_EQ(decode(options, stats), "[?] corrupted level\n[error] valid level\n");
+	EXPECT_EQ(stats.written, 2u);
+	EXPECT_EQ(stats.errors, 1u);
+
+	fs::remove(log_file);
+}
+
+TEST(LoggerTest, FormatStringLogging)
+{
+	logger::LoggerConfig config;
+	config.log_pattern = "[{{level}}] {{message}}";
+	config.log_level = logger::Level::INFO;
+
+	logger::Logger<MokStringPolicy> log(config);
+
+	NotPackable::format_calls = 0;
+	MokStringPolicy::output.clear();
+
+	log.debug("filtered {}", NotPackable{ 1 });
+	EXPECT_EQ(NotPackable::format_calls, 0);
+	EXPECT_TRUE(MokStringPolicy::output.empty());
+
+	log.info("{} + {} = {:.1f}", NotPackable{ 2 }, 3u, 5.0);
+	EXPECT_EQ(NotPackable::format_calls, 1);
+	EXPECT_EQ(MokStringPolicy::output, "[info] 2 + 3 = 5.0");
+
+	log.log(logger::Level::ERROR, "{:>6}", "right");
+	EXPECT_EQ(MokStringPolicy::output, "[error]  right");
+
+	log.warning("{{escaped}}");
+	EXPECT_EQ(MokStringPolicy::output, "[warning] {{escaped}}");
+}
+
+TEST(LoggerTest, StaticMinLevel)
+{
+	using logger_t = logger::Logger<logger::StaticMinLevel<logger::Level::WARNING>, MokStringPolicy>;
+
+	static_assert(logger::is_logger<logger_t>);
+	static_assert(logger::logger_min_level_v<logger_t> == logger::Level::WARNING);
+	static_assert(!logger_t::is_enabled(logger::Level::INFO));
+	static_assert(logger_t::is_enabled(logger::Level::ERROR));
+	static_assert(logger::logger_min_level_v<logger::Logger<MokStringPolicy>> == logger::DEFAULT_STATIC_MIN_LEVEL);
+
+	logger::LoggerConfig config;
+	config.log_pattern = "[{{level}}] {{message}}";
+
+	logger_t log(config);
+	MokStringPolicy::output.clear();
+
+	size_t evaluations = 0;
+	auto evaluate = [&evaluations]()
+	{
+		++evaluations;
+		return evaluations;
+	};
+
+	LOGGER_DEBUG(log, "{}", evaluate());
+	LOGGER_INFO(log, "{}", evaluate());
+	log.log(logger::Level::DEBUG, "runtime level");
+	log.info("info");
+	EXPECT_EQ(evaluations, 0);
+	EXPECT_TRUE(MokStringPolicy::output.empty());
+
+	LOGGER_ERROR(log, "{}", evaluate());
+	EXPECT_EQ(evaluations, 1);
+	EXPECT_EQ(MokStringPolicy::output, "[error] 1");
+}
+
+TEST(LoggerTest, RuntimeLevelChange)
 {
 	logger::LoggerConfig config;
+	config.log_pattern = "{{message}}";
 	config.log_level = logger::Level::WARNING;
-	config.log_pattern = "[{{time}}][{{level}}] {{message}}";
 
-	std::string_view check_pattern = "[{0}][{2}] {3}";
-	std::string_view message = "some text message";
+	logger::Logger<MokStringPolicy> log(config);
+	EXPECT_EQ(log.get_level(), logger::Level::WARNING);
+
+	MokStringPolicy::output.clear();
+	log.debug("first");
+	EXPECT_TRUE(MokStringPolicy::output.empty());
+
+	log.set_level(logger::Level::DEBUG);
+	EXPECT_EQ(log.get_level(), logger::Level::DEBUG);
+	log.debug("second");
+	EXPECT_EQ(MokStringPolicy::output, "second");
 
+	log.set_level(logger::Level::ERROR);
+	log.warning("third");
+	EXPECT_EQ(MokStringPolicy::output, "second");
+	EXPECT_EQ(log.get_config().log_level, logger::Level::WARNING);
+}
+
+TEST(LoggerTest, ThreadId)
+{
 	std::stringstream ss;
 	ss << std::this_thread::get_id();
-	std::string thread_id = ss.str();
 
-	auto time_provider = logger::DependencyContainer::get<logger::TimeProvider>();
+	const std::string_view std_id = logger::this_thread_id(logger::ThreadIdType::STD);
+	EXPECT_EQ(std_id, ss.str());
+	EXPECT_EQ(std_id.data(), logger::this_thread_id(logger::ThreadIdType::STD).data());
+
+	const std::string system_id (logger::this_thread_id(logger::ThreadIdType::SYSTEM));
+	EXPECT_FALSE(system_id.empty());
+	EXPECT_TRUE(std::ranges::all_of(system_id, [](char c) { return std::isdigit(static_cast<unsigned char>(c)); }));
 
+	std::string other_thread_id;
+	std::thread([&other_thread_id]()
 	{
-		auto log = logger::Logger<MokStringPolicy>(config);
-		log.error(message);
+		logger::set_this_thread_name("worker");
+		other_thread_id = logger::this_thread_id(logger::ThreadIdType::SYSTEM);
+	}).join();
+
+	EXPECT_EQ(other_thread_id, "worker");
+	EXPECT_EQ(logger::this_thread_id(logger::ThreadIdType::SYSTEM), system_id);
+
+	EXPECT_EQ(logger::str_to_thread_id_type("system"), logger::ThreadIdType::SYSTEM);
+	EXPECT_THROW(logger::str_to_thread_id_type("unknown"), std::runtime_error);
+}
+
+TEST(LoggerTest, ThreadNameLogging)
+{
+	logger::LoggerConfig config;
+	config.log_pattern = "{{thread-id}}: {{message}}";
+	config.thread_id_type = logger::ThreadIdType::SYSTEM;
+
+	MokCollectPolicy::output.clear();
+
+	{
+		logger::AsyncLogger<MokCollectPolicy> log(config);
+
+		std::thread([&log]()
+		{
+			logger::set_this_thread_name("named thread");
+			log.info("{}", 1);
+		}).join();
+
+		log.info("{}", 2);
 	}
 
-	std::string check_message = std::vformat(check_pattern, std::make_format_args(time_provider->now(),
-														    thread_id,
-														    logger::level_to_str(logger::Level::ERROR),
-														    message));
+	ASSERT_EQ(MokCollectPolicy::output.size(), 2);
+	EXPECT_EQ(MokCollectPolicy::output[0], "named thread: 1");
+	EXPECT_EQ(MokCollectPolicy::output[1], std::format("{}: 2", logger::this_thread_id(logger::ThreadIdType::SYSTEM)));
+}
 
-	EXPECT_EQ(check_message, MokStringPolicy::output);
+TEST(LoggerTest, AsyncLoggerConcepts)
+{
+	using logger_t = logger::AsyncLogger<logger::DefaultConsoleLoggerPolicy>;
+
+	static_assert(logger::is_logger<logger_t>);
+	static_assert(logger::logger_has_policy<logger_t, logger::DefaultConsoleLoggerPolicy>);
+	static_assert(logger::logger_has_no_policy<logger_t, logger::DefaultFileLoggerPolicy>);
+}
+
+TEST(LoggerTest, ConfigParsingAsyncQueueSize)
+{
+	auto config = logger::read_config_from_json(R"({ "logger" : { "async_queue_size": 1024 } })");
+	EXPECT_EQ(config.async_queue_size, 1024);
+
+	config = logger::read_config_from_json(R"({ "logger" : { "async_queue_size": "big" } })");
+	EXPECT_EQ(config.async_queue_size, logger::DEFAULT_ASYNC_QUEUE_SIZE);
+
+	config.async_queue_size = 0;
+	EXPECT_FALSE(std::get<0>(logger::validate_config(config)));
 }
 
 }
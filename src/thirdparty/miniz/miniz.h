@@ -0,0 +1,167 @@
+/* miniz - deflate compressor (tdefl) and CRC-32, MIT license (see LICENSE)
+
+   This is not an unmodified miniz release: it is the tdefl compressor and mz_crc32 of miniz
+   (https://github.com/richgel999/miniz) reduced to raw deflate streams (no zlib wrapper, no inflate and
+   no zip archives), see .info. Declarations used by the logger are the same as in miniz.h of miniz 3.0.2,
+   so miniz.h and miniz.c of the 3.0.2 release replace these files as they are. */
+
+#ifndef MINIZ_HEADER_INCLUDED
+#define MINIZ_HEADER_INCLUDED
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef unsigned char mz_uint8;
+typedef unsigned short mz_uint16;
+typedef unsigned int mz_uint32;
+typedef uint64_t mz_uint64;
+typedef unsigned int mz_uint;
+typedef unsigned long mz_ulong;
+
+#define MZ_CRC32_INIT (0)
+
+/* Update the CRC-32 of the data (as gzip computes it). Call with crc MZ_CRC32_INIT first. */
+mz_ulong mz_crc32(mz_ulong crc, const unsigned char *ptr, size_t buf_len);
+
+/* tdefl_init() compression flags logically OR'd together (low 12 bits contain the max. number of probes per
+   dictionary search): TDEFL_DEFAULT_MAX_PROBES: The compressor defaults to 128 dictionary probes per dictionary
+   search. 0=Huffman only, 1=Huffman+LZ (fastest/crap compression), 4095=Huffman+LZ (slowest/best compression). */
+enum
+{
+	TDEFL_HUFFMAN_ONLY = 0,
+	TDEFL_DEFAULT_MAX_PROBES = 128,
+	TDEFL_MAX_PROBES_MASK = 0xFFF
+};
+
+/* TDEFL_GREEDY_PARSING_FLAG: Set to use faster greedy parsing, instead of more efficient lazy parsing.
+   TDEFL_RLE_MATCHES: Only look for RLE matches (matches with a distance of 1).
+   TDEFL_FILTER_MATCHES: Discards matches <= 5 chars if enabled.
+   TDEFL_FORCE_ALL_STATIC_BLOCKS: Disable usage of optimized Huffman tables.
+   TDEFL_FORCE_ALL_RAW_BLOCKS: Only use raw (uncompressed) deflate blocks. */
+enum
+{
+	TDEFL_GREEDY_PARSING_FLAG = 0x04000,
+	TDEFL_RLE_MATCHES = 0x10000,
+	TDEFL_FILTER_MATCHES = 0x20000,
+	TDEFL_FORCE_ALL_STATIC_BLOCKS = 0x40000,
+	TDEFL_FORCE_ALL_RAW_BLOCKS = 0x80000
+};
+
+enum
+{
+	TDEFL_MAX_HUFF_TABLES = 3,
+	TDEFL_MAX_HUFF_SYMBOLS_0 = 288,
+	TDEFL_MAX_HUFF_SYMBOLS_1 = 32,
+	TDEFL_MAX_HUFF_SYMBOLS_2 = 19,
+	TDEFL_LZ_DICT_SIZE = 32768,
+	TDEFL_LZ_DICT_SIZE_MASK = TDEFL_LZ_DICT_SIZE - 1,
+	TDEFL_MIN_MATCH_LEN = 3,
+	TDEFL_MAX_MATCH_LEN = 258
+};
+
+enum
+{
+	TDEFL_LZ_CODE_BUF_SIZE = 64 * 1024,
+	TDEFL_OUT_BUF_SIZE = (TDEFL_LZ_CODE_BUF_SIZE * 13) / 10,
+	TDEFL_MAX_HUFF_SYMBOLS = 288,
+	TDEFL_LZ_HASH_BITS = 15,
+	TDEFL_LEVEL1_HASH_SIZE_MASK = 4095,
+	TDEFL_LZ_HASH_SHIFT = (TDEFL_LZ_HASH_BITS + 2) / 3,
+	TDEFL_LZ_HASH_SIZE = 1 << TDEFL_LZ_HASH_BITS
+};
+
+typedef enum
+{
+	TDEFL_STATUS_BAD_PARAM = -2,
+	TDEFL_STATUS_PUT_BUF_FAILED = -1,
+	TDEFL_STATUS_OKAY = 0,
+	TDEFL_STATUS_DONE = 1
+} tdefl_status;
+
+/* Must map to MZ_NO_FLUSH, MZ_SYNC_FLUSH, etc. enums */
+typedef enum
+{
+	TDEFL_NO_FLUSH = 0,
+	TDEFL_SYNC_FLUSH = 2,
+	TDEFL_FULL_FLUSH = 3,
+	TDEFL_FINISH = 4
+} tdefl_flush;
+
+/* tdefl's compression state structure. */
+typedef struct
+{
+	mz_uint m_flags, m_max_probes[2];
+	int m_greedy_parsing;
+	size_t m_lookahead_pos, m_lookahead_size, m_dict_size, m_lz_code_buf_dict_pos;
+	mz_uint m_lz_code_pos, m_lz_flags_pos, m_num_flags_left, m_total_lz_bytes;
+	mz_uint m_bits_in, m_bit_buffer;
+	mz_uint m_saved_match_dist, m_saved_match_len, m_saved_lit;
+	mz_uint m_output_flush_ofs, m_output_flush_remaining, m_finished, m_block_index;
+	tdefl_status m_prev_return_status;
+	tdefl_flush m_flush;
+	const mz_uint8 *m_pIn_buf;
+	size_t m_in_buf_size, m_src_pos;
+	mz_uint8 *m_pOut_buf;
+	size_t m_out_buf_size, m_out_buf_ofs;
+	mz_uint8 m_dict[TDEFL_LZ_DICT_SIZE + TDEFL_MAX_MATCH_LEN - 1 + 1];
+	mz_uint16 m_huff_count[TDEFL_MAX_HUFF_TABLES][TDEFL_MAX_HUFF_SYMBOLS];
+	mz_uint16 m_huff_codes[TDEFL_MAX_HUFF_TABLES][TDEFL_MAX_HUFF_SYMBOLS];
+	mz_uint8 m_huff_code_sizes[TDEFL_MAX_HUFF_TABLES][TDEFL_MAX_HUFF_SYMBOLS];
+	mz_uint8 m_lz_code_buf[TDEFL_LZ_CODE_BUF_SIZE];
+	mz_uint16 m_next[TDEFL_LZ_DICT_SIZE];
+	mz_uint16 m_hash[TDEFL_LZ_HASH_SIZE];
+	mz_uint8 m_output_buf[TDEFL_OUT_BUF_SIZE];
+} tdefl_compressor;
+
+/* Initializes the compressor. flags: See the above enums (TDEFL_HUFFMAN_ONLY, TDEFL_GREEDY_PARSING_FLAG, etc.) */
+tdefl_status tdefl_init(tdefl_compressor *d, int flags);
+
+/* Compresses a block of data, consuming as much of the specified input buffer as possible, and writing as much
+   compressed data to the specified output buffer as possible. On return *pIn_buf_size and *pOut_buf_size are
+   the numbers of consumed and written bytes. Call with TDEFL_FINISH until TDEFL_STATUS_DONE is returned. */
+tdefl_status tdefl_compress(tdefl_compressor *d, const void *pIn_buf, size_t *pIn_buf_size, void *pOut_buf,
+							size_t *pOut_buf_size, tdefl_flush flush);
+
+tdefl_status tdefl_get_prev_return_status(tdefl_compressor *d);
+
+/* Create tdefl_compress() flags given zlib-style compression parameters.
+   level may range from [0,10] (where 10 is absolute max compression, but may be much slower on some files)
+   window_bits may be -15 (raw deflate) or 15 (zlib), only raw deflate is supported by this copy
+   strategy may be either MZ_DEFAULT_STRATEGY, MZ_FILTERED, MZ_HUFFMAN_ONLY, MZ_RLE, or MZ_FIXED */
+mz_uint tdefl_create_comp_flags_from_zip_params(int level, int window_bits, int strategy);
+
+/* Allocate the tdefl_compressor structure in C so that non-C language bindings to tdefl_ API don't need to
+   worry about structure size and allocation mechanism. */
+tdefl_compressor *tdefl_compressor_alloc(void);
+void tdefl_compressor_free(tdefl_compressor *pComp);
+
+enum
+{
+	MZ_DEFAULT_STRATEGY = 0,
+	MZ_FILTERED = 1,
+	MZ_HUFFMAN_ONLY = 2,
+	MZ_RLE = 3,
+	MZ_FIXED = 4
+};
+
+enum
+{
+	MZ_NO_COMPRESSION = 0,
+	MZ_BEST_SPEED = 1,
+	MZ_BEST_COMPRESSION = 9,
+	MZ_UBER_COMPRESSION = 10,
+	MZ_DEFAULT_LEVEL = 6,
+	MZ_DEFAULT_COMPRESSION = -1
+};
+
+#define MZ_DEFAULT_WINDOW_BITS 15
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MINIZ_HEADER_INCLUDED */